@@ -0,0 +1,62 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <stdlib.h>
+
+#include "../sources/queue/thread-safe-queue.h"
+#include "../sources/queue/lock-free-queue.h"
+
+/*
+ * Сравнение очередей задач: producers потоков (реакторы) кладут задачи, consumers потоков (воркеры)
+ * забирают их блокирующим wait_and_pop. Запуск: queue-benchmark [producers] [consumers] [операций на производителя]
+ */
+
+template <typename Queue>
+static double run(Queue & queue, int producers, int consumers, long count) {
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < consumers; i++)
+        threads.emplace_back([&queue] {
+            for (;;) {
+                long value;
+                queue.wait_and_pop(value);
+                if (value < 0)
+                    return;
+            }
+        });
+    for (int i = 0; i < producers; i++)
+        threads.emplace_back([&queue, count] {
+            for (long j = 0; j < count; j++)
+                queue.push(j);
+        });
+    for (int i = consumers; i < consumers + producers; i++)
+        threads[i].join();
+    for (int i = 0; i < consumers; i++)
+        queue.push(-1);
+    for (int i = 0; i < consumers; i++)
+        threads[i].join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return producers * count / elapsed.count();
+}
+
+int main(int argc, char **argv) {
+    int producers = argc > 1 ? atoi(argv[1]) : 1;
+    int consumers = argc > 2 ? atoi(argv[2]) : 8;
+    long count = argc > 3 ? atol(argv[3]) : 2000000;
+
+    onyxup::ThreadSafeQueue<long> threadSafeQueue;
+    onyxup::LockFreeQueue<long> lockFreeQueue;
+
+    double mutex_ops = run(threadSafeQueue, producers, consumers, count);
+    double lock_free_ops = run(lockFreeQueue, producers, consumers, count);
+
+    std::cout << "producers=" << producers << " consumers=" << consumers << " operations=" << producers * count
+              << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << std::setw(20) << std::left << "ThreadSafeQueue" << mutex_ops << " ops/s" << std::endl;
+    std::cout << std::setw(20) << std::left << "LockFreeQueue" << lock_free_ops << " ops/s" << std::endl;
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <stdlib.h>
+
+#include "../sources/route/router.h"
+
+/*
+ * Сравнение поиска маршрута: последовательный regexec по всем маршрутам (как было в диспетчере)
+ * и radix дерево Router. Запуск: router-benchmark [маршрутов] [поисков]
+ */
+
+int main(int argc, char **argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 300;
+    long lookups = argc > 2 ? atol(argv[2]) : 200000;
+
+    std::function<onyxup::ResponseBase(onyxup::PtrCRequest)> handler = [](onyxup::PtrCRequest) {
+        return onyxup::ResponseBase();
+    };
+    std::vector<onyxup::Route> routes;
+    onyxup::Router router;
+    std::vector<std::string> uris;
+    for (int i = 0; i < count; i++) {
+        std::string regex = "^/api/v1/resource-" + std::to_string(i) + "$";
+        routes.push_back(onyxup::Route("GET", regex.c_str(), handler, onyxup::EnumTaskType::LOCAL_TASK));
+        router.addRegexRoute("GET", regex.c_str(), handler, onyxup::EnumTaskType::LOCAL_TASK);
+        uris.push_back("/api/v1/resource-" + std::to_string(i));
+    }
+
+    size_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lookups; i++) {
+        const std::string &uri = uris[i % uris.size()];
+        for (auto &route : routes) {
+            regmatch_t pm;
+            if (route.getMethodRef() == "GET" && regexec(&route.getPregex(), uri.c_str(), 0, &pm, 0) == 0) {
+                found++;
+                break;
+            }
+        }
+    }
+    double linear = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (long i = 0; i < lookups; i++)
+        if (router.match("GET", uris[i % uris.size()], nullptr))
+            found++;
+    double tree = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "routes=" << count << " lookups=" << lookups << " found=" << found << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << std::setw(20) << std::left << "regexec scan" << lookups / linear << " lookups/s" << std::endl;
+    std::cout << std::setw(20) << std::left << "Router" << lookups / tree << " lookups/s" << std::endl;
+    return 0;
+}
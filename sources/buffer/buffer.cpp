@@ -2,42 +2,140 @@
 
 #include "buffer.h"
 
-onyxup::PtrBuffer onyxup::buffer::bufferFactory(size_t in_len, size_t out_len) {
-    PtrBuffer buffer = new (std::nothrow) Buffer;
+onyxup::BufferPool::BufferPool(size_t maxInputBufferLength) : maxInputBufferLength(maxInputBufferLength) {
+}
+
+onyxup::BufferPool::~BufferPool() {
+    for (auto buffer : freeBuffers)
+        delete buffer;
+    for (size_t i = 0; i < freeChunks.size(); i++)
+        for (auto chunk : freeChunks[i])
+            delete[] chunk;
+}
+
+size_t onyxup::BufferPool::getSizeClass(size_t length) {
+    size_t size_class = 0;
+    while ((INITIAL_BUFFER_LENGTH << size_class) < length)
+        size_class++;
+    return size_class;
+}
+
+onyxup::PtrBuffer onyxup::BufferPool::getBuffer() {
+    PtrBuffer buffer = nullptr;
+    if (!freeBuffers.empty()) {
+        buffer = freeBuffers.back();
+        freeBuffers.pop_back();
+    } else {
+        buffer = new (std::nothrow) Buffer(this);
+        if (buffer == nullptr)
+            return nullptr;
+    }
+    buffer->maxInputBufferLength = maxInputBufferLength;
+    return buffer;
+}
+
+void onyxup::BufferPool::releaseBuffer(PtrBuffer buffer) {
+    if (buffer == nullptr)
+        return;
+    if (buffer->inputBuffer)
+        deallocate(buffer->inputBuffer, buffer->inputBufferLength);
+    buffer->inputBuffer = nullptr;
+    buffer->inputBufferLength = 0;
+    buffer->posInputBuffer = 0;
+    buffer->numberBytesToSend = 0;
+    if (freeBuffers.size() < MAX_POOLED_BUFFERS)
+        freeBuffers.push_back(buffer);
+    else
+        delete buffer;
+}
+
+char * onyxup::BufferPool::allocate(size_t &length) {
+    size_t size_class = getSizeClass(length);
+    length = INITIAL_BUFFER_LENGTH << size_class;
+    if (size_class < freeChunks.size() && !freeChunks[size_class].empty()) {
+        char *chunk = freeChunks[size_class].back();
+        freeChunks[size_class].pop_back();
+        pooledBytes -= length;
+        return chunk;
+    }
+    return new (std::nothrow) char[length];
+}
+
+void onyxup::BufferPool::deallocate(char *chunk, size_t length) {
+    if (pooledBytes + length > MAX_POOLED_BYTES) {
+        delete[] chunk;
+        return;
+    }
+    size_t size_class = getSizeClass(length);
+    if (size_class >= freeChunks.size())
+        freeChunks.resize(size_class + 1);
+    freeChunks[size_class].push_back(chunk);
+    pooledBytes += length;
+}
+
+bool onyxup::Buffer::growBuffer(char *&buffer, size_t &length, size_t used, size_t required, size_t max) {
+    if (required <= length)
+        return true;
+    if (required > max)
+        return false;
+    size_t new_length = length ? length : BufferPool::INITIAL_BUFFER_LENGTH;
+    while (new_length < required)
+        new_length *= 2;
+    char *new_buffer = pool->allocate(new_length);
+    if (new_buffer == nullptr)
+        return false;
     if (buffer) {
-        buffer->inputBufferLength = in_len;
-        buffer->outputBufferLength = out_len;
-        buffer->inputBuffer = new (std::nothrow) char[in_len];
-        buffer->outputBuffer = new (std::nothrow) char[out_len];
-        if (buffer->inputBuffer && buffer->outputBuffer) {
-            buffer->posOutputBuffer = 0;
-            buffer->posInputBuffer = 0;
-            buffer->numberBytesToSend = 0;
-            return buffer;
-        } else {
-            delete buffer;
-        }
+        memcpy(new_buffer, buffer, used);
+        pool->deallocate(buffer, length);
     }
-    return nullptr;
+    buffer = new_buffer;
+    length = new_length;
+    return true;
 }
 
 void onyxup::Buffer::clear() {
-    posOutputBuffer = 0;
     posInputBuffer = 0;
     numberBytesToSend = 0;
+    /*
+     * Выросший буфер возвращаем в пул, чтобы бездействующее соединение не удерживало память
+     */
+    if (inputBuffer && inputBufferLength > BufferPool::INITIAL_BUFFER_LENGTH) {
+        pool->deallocate(inputBuffer, inputBufferLength);
+        inputBuffer = nullptr;
+        inputBufferLength = 0;
+    }
 }
 
-void onyxup::Buffer::addDataToInputBuffer(const char* data, size_t n) {
-    memcpy(inputBuffer + posInputBuffer, data, n);
-    posInputBuffer += n;
+size_t onyxup::Buffer::reserveInputBuffer(size_t n) {
+    size_t required = posInputBuffer + n;
+    if (required > maxInputBufferLength)
+        required = maxInputBufferLength;
+    if (!growBuffer(inputBuffer, inputBufferLength, posInputBuffer, required, maxInputBufferLength))
+        return 0;
+    size_t length = inputBufferLength < maxInputBufferLength ? inputBufferLength : maxInputBufferLength;
+    return length > posInputBuffer ? length - posInputBuffer : 0;
 }
 
-void onyxup::Buffer::addDataToOutputBuffer(const char * data, size_t n) {
-    memcpy(outputBuffer + posOutputBuffer, data, n);
-    numberBytesToSend += n;
+void onyxup::Buffer::consumeInputBuffer(size_t n) {
+    eraseInputBuffer(0, n);
+}
+
+void onyxup::Buffer::eraseInputBuffer(size_t pos, size_t n) {
+    if (n == 0 || pos >= posInputBuffer)
+        return;
+    if (pos + n < posInputBuffer)
+        memmove(inputBuffer + pos, inputBuffer + pos + n, posInputBuffer - pos - n);
+    posInputBuffer = pos + n < posInputBuffer ? posInputBuffer - n : pos;
+}
+
+bool onyxup::Buffer::addDataToInputBuffer(const char* data, size_t n) {
+    if (!growBuffer(inputBuffer, inputBufferLength, posInputBuffer, posInputBuffer + n, maxInputBufferLength))
+        return false;
+    memcpy(inputBuffer + posInputBuffer, data, n);
+    posInputBuffer += n;
+    return true;
 }
 
 onyxup::Buffer::~Buffer() {
     delete [] inputBuffer;
-    delete [] outputBuffer;
-}
\ No newline at end of file
+}
@@ -1,33 +1,44 @@
 #pragma once
 
 #include <string.h>
+#include <vector>
 #include "../plog/Log.h"
 
 namespace onyxup {
-    
+
     class Buffer;
-    
+
+    class BufferPool;
+
     using PtrBuffer = Buffer *;
-    
-    namespace buffer {
-        PtrBuffer bufferFactory(size_t in_len, size_t out_len);
-    }
 
+    using PtrBufferPool = BufferPool *;
+
+    /*
+     * Буфер соединения. Память под входной буфер выделяется лениво и растет геометрически
+     * (начиная с BufferPool::INITIAL_BUFFER_LENGTH) до заданного максимума.
+     * Ответы отправляются прямо из задач, буфер хранит только количество байт, ожидающих отправки
+     */
     class Buffer {
-        friend PtrBuffer buffer::bufferFactory(size_t in_len, size_t out_len);
+        friend class BufferPool;
     private:
+        PtrBufferPool pool;
+
         char * inputBuffer;
-        char * outputBuffer;
-        size_t posOutputBuffer;
         size_t posInputBuffer;
         size_t numberBytesToSend;
 
         size_t  inputBufferLength;
-        size_t  outputBufferLength;
 
-        Buffer(){}
+        size_t  maxInputBufferLength;
+
+        Buffer(PtrBufferPool pool) : pool(pool), inputBuffer(nullptr), posInputBuffer(0), numberBytesToSend(0),
+                                     inputBufferLength(0), maxInputBufferLength(0) {}
+
+        bool growBuffer(char *& buffer, size_t & length, size_t used, size_t required, size_t max);
+
     public:
-        
+
         ~Buffer();
 
         void clear();
@@ -35,35 +46,93 @@ namespace onyxup {
         inline char* getInputBuffer() {
             return inputBuffer;
         }
-        
-        inline char* getOutputBuffer() const {
-            return outputBuffer;
-        }
 
         inline size_t getPosInputBuffer() const {
             return posInputBuffer;
         }
-        
-        inline size_t getPosOutputBuffer() const {
-            return posOutputBuffer;
-        }
-        
+
         inline size_t getBytesToSend() const {
             return numberBytesToSend;
         }
-        
-        inline void setPosOutputBuffer(size_t pos) {
-            posOutputBuffer = pos;
+
+        inline size_t getMaxInputBufferLength() const {
+            return maxInputBufferLength;
+        }
+
+        inline char* getInputBufferTail() {
+            return inputBuffer + posInputBuffer;
+        }
+
+        inline void commitInputBuffer(size_t n) {
+            posInputBuffer += n;
         }
-        
+
+        /*
+         * Удаляет из начала входного буфера n байт уже разобранных запросов,
+         * остаток (начало следующего запроса) сдвигается в начало буфера
+         */
+        void consumeInputBuffer(size_t n);
+
+        /*
+         * Удаляет n байт с позиции pos входного буфера, данные после них сдвигаются
+         */
+        void eraseInputBuffer(size_t pos, size_t n);
+
+        /*
+         * Увеличивает входной буфер так, чтобы в нем было свободно не меньше n байт
+         * (но не больше максимального размера). Возвращает размер свободной части
+         */
+        size_t reserveInputBuffer(size_t n);
+
+        /*
+         * Количество байт готовых ответов соединения, еще не принятых сокетом
+         */
         inline void setBytesToSend(size_t n) {
             numberBytesToSend = n;
         }
 
-        void addDataToInputBuffer(const char * data, size_t n);
-        void addDataToOutputBuffer(const char * data, size_t n);
+        /*
+         * Возвращает false, если после добавления данных будет превышен максимальный размер буфера
+         */
+        bool addDataToInputBuffer(const char * data, size_t n);
     };
 
-    
+    /*
+     * Пул буферов реактора. Хранит свободные объекты Buffer и свободные блоки памяти,
+     * разбитые по классам размеров (INITIAL_BUFFER_LENGTH * 2^i).
+     * Не потокобезопасен - используется только потоком своего реактора
+     */
+    class BufferPool {
+    private:
+        size_t maxInputBufferLength;
+
+        std::vector<PtrBuffer> freeBuffers;
+        std::vector<std::vector<char *>> freeChunks;
+        size_t pooledBytes = 0;
+
+        static size_t getSizeClass(size_t length);
+
+    public:
+
+        static constexpr size_t INITIAL_BUFFER_LENGTH = 16 * 1024;
+        static constexpr size_t MAX_POOLED_BYTES = 64 * 1024 * 1024;
+        static constexpr size_t MAX_POOLED_BUFFERS = 1024;
+
+        explicit BufferPool(size_t maxInputBufferLength);
+
+        BufferPool(const BufferPool &) = delete;
+        ~BufferPool();
+
+        PtrBuffer getBuffer();
+
+        void releaseBuffer(PtrBuffer buffer);
+
+        /*
+         * Выделяет блок памяти не меньше length байт, фактический размер возвращается в length
+         */
+        char * allocate(size_t & length);
+
+        void deallocate(char * chunk, size_t length);
+    };
 
-}
\ No newline at end of file
+}
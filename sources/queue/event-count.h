@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+namespace onyxup {
+
+    /*
+     * Eventcount на futex: потребитель, не нашедший данных, регистрируется (prepareWait),
+     * еще раз проверяет данные и засыпает (wait) или отменяет ожидание (cancelWait).
+     * Производитель после публикации данных вызывает notify - системный вызов делается,
+     * только если есть зарегистрированные потребители. Пропускать пробуждение, пока предыдущий
+     * разбуженный не проснулся, нельзя: потребитель, отменивший ожидание, не отличает
+     * предназначенное ему пробуждение от чужого, и признак ожидаемого пробуждения мог остаться
+     * взведенным навсегда
+     */
+    class EventCount {
+    private:
+        static constexpr size_t CACHE_LINE_LENGTH = 64;
+
+        alignas(CACHE_LINE_LENGTH) std::atomic<uint32_t> epoch{0};
+        std::atomic<uint32_t> waiters{0};
+
+    public:
+
+        inline uint32_t prepareWait() {
+            uint32_t key = epoch.load(std::memory_order_acquire);
+            waiters.fetch_add(1, std::memory_order_relaxed);
+            /*
+             * Барьер между регистрацией и повторной проверкой данных, парный барьеру в notify
+             */
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return key;
+        }
+
+        inline void cancelWait() {
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        inline void wait(uint32_t key) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch), FUTEX_WAIT_PRIVATE, key, nullptr, nullptr, 0);
+            waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        inline void notify() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (waiters.load(std::memory_order_relaxed) > 0) {
+                epoch.fetch_add(1, std::memory_order_release);
+                syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+            }
+        }
+    };
+}
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "event-count.h"
+
+namespace onyxup {
+
+    /*
+     * Ограниченная lock-free очередь MPMC (кольцевой буфер Д. Вьюкова).
+     * Каждая ячейка хранит номер последовательности, по которому производитель и потребитель
+     * определяют, свободна ли ячейка для записи или чтения на текущем круге.
+     * Потребитель, не дождавшийся данных за SPIN_COUNT попыток, засыпает на EventCount
+     */
+    template <typename T>
+    class LockFreeQueue {
+    private:
+        static constexpr size_t CACHE_LINE_LENGTH = 64;
+        static constexpr int SPIN_COUNT = 128;
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        std::vector<Cell> buffer;
+        size_t mask;
+
+        alignas(CACHE_LINE_LENGTH) std::atomic<size_t> enqueuePos{0};
+        alignas(CACHE_LINE_LENGTH) std::atomic<size_t> dequeuePos{0};
+        EventCount events;
+
+    public:
+
+        static inline void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+
+        /*
+         * capacity округляется вверх до степени двойки
+         */
+        explicit LockFreeQueue(size_t capacity = 65536) {
+            size_t length = 2;
+            while (length < capacity)
+                length <<= 1;
+            buffer = std::vector<Cell>(length);
+            mask = length - 1;
+            for (size_t i = 0; i < length; i++)
+                buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        LockFreeQueue(const LockFreeQueue &) = delete;
+        LockFreeQueue & operator=(const LockFreeQueue &) = delete;
+
+        /*
+         * Возвращает false, если очередь заполнена
+         */
+        bool try_push(const T & value) {
+            Cell *cell;
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                cell = &buffer[pos & mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0)
+                    return false;
+                else
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+            cell->data = value;
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            events.notify();
+            return true;
+        }
+
+        /*
+         * Ждет свободного места, если очередь заполнена
+         */
+        void push(const T & value) {
+            while (!try_push(value))
+                std::this_thread::yield();
+        }
+
+        bool try_pop(T & value) {
+            Cell *cell;
+            size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                cell = &buffer[pos & mask];
+                size_t seq = cell->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0)
+                    return false;
+                else
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+            value = cell->data;
+            cell->sequence.store(pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        void wait_and_pop(T & value) {
+            for (int i = 0; i < SPIN_COUNT; i++) {
+                if (try_pop(value))
+                    return;
+                pause();
+            }
+            for (;;) {
+                uint32_t key = events.prepareWait();
+                if (try_pop(value)) {
+                    events.cancelWait();
+                    return;
+                }
+                events.wait(key);
+                if (try_pop(value)) {
+                    /*
+                     * В очереди остались данные - будим следующего спящего потребителя
+                     */
+                    if (!empty())
+                        events.notify();
+                    return;
+                }
+            }
+        }
+
+        /*
+         * Приблизительный размер без блокировок: при одновременных push/pop может отставать
+         */
+        size_t size() const {
+            size_t tail = dequeuePos.load(std::memory_order_relaxed);
+            size_t head = enqueuePos.load(std::memory_order_relaxed);
+            return head > tail ? head - tail : 0;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+    };
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include "../task/task.h"
+
+namespace onyxup {
+
+    /*
+     * Очередь ответов соединения в порядке поступления запросов (HTTP/1.1 pipelining).
+     * Интрузивный односвязный список по полю Task::next, память не выделяет.
+     * Готовые ответы из начала очереди отправляются прямо из задач, очередь помнит,
+     * сколько байт первого ответа уже отправлено.
+     * Не потокобезопасна - используется только потоком своего реактора
+     */
+    class ResponseQueue {
+    private:
+        PtrTask head = nullptr;
+        PtrTask tail = nullptr;
+        size_t length = 0;
+        size_t sent = 0;
+
+        static inline size_t addSegment(struct iovec * iov, size_t count, const std::string & data, size_t offset) {
+            if (offset >= data.size())
+                return count;
+            iov[count].iov_base = const_cast<char *>(data.data() + offset);
+            iov[count].iov_len = data.size() - offset;
+            return count + 1;
+        }
+    public:
+
+        inline void push(PtrTask task) {
+            task->setNext(nullptr);
+            if (tail)
+                tail->setNext(task);
+            else
+                head = task;
+            tail = task;
+            length++;
+        }
+
+        inline PtrTask front() const {
+            return head;
+        }
+
+        inline PtrTask pop() {
+            PtrTask task = head;
+            sent = 0;
+            if (task) {
+                head = task->getNext();
+                if (head == nullptr)
+                    tail = nullptr;
+                task->setNext(nullptr);
+                length--;
+            }
+            return task;
+        }
+
+        inline bool empty() const {
+            return head == nullptr;
+        }
+
+        inline size_t size() const {
+            return length;
+        }
+
+        /*
+         * Количество уже отправленных байт первого ответа
+         */
+        inline size_t getSent() const {
+            return sent;
+        }
+
+        /*
+         * Заполняет iov неотправленными частями (заголовок, тело) готовых ответов из начала очереди,
+         * не больше max элементов. Отображенный в память файл добавляется в iov, на неотображенном
+         * заполнение останавливается: следующим отправляется файл. Возвращает количество заполненных элементов
+         */
+        inline size_t fill(struct iovec * iov, size_t max) const {
+            size_t count = 0;
+            size_t offset = sent;
+            for (PtrTask task = head; task && task->isPerformed() && count + 2 <= max; task = task->getNext()) {
+                const std::string & header = task->getResponseHeader();
+                count = addSegment(iov, count, header, offset);
+                const std::string & body = task->getResponseBody();
+                count = addSegment(iov, count, body, offset > header.size() ? offset - header.size() : 0);
+                const FileRange & file = task->getResponseFile();
+                if (file.length > 0) {
+                    if (!file.file->isInMemory() || count == max)
+                        break;
+                    size_t prefix = header.size() + body.size();
+                    size_t skip = offset > prefix ? offset - prefix : 0;
+                    iov[count].iov_base = const_cast<char *>(file.file->getData() + file.offset + skip);
+                    iov[count].iov_len = file.length - skip;
+                    count++;
+                }
+                offset = 0;
+            }
+            return count;
+        }
+
+        /*
+         * Если у первого ответа отправлены заголовок и тело и осталась часть неотображенного файла, записывает
+         * дескриптор, позицию в файле и длину неотправленной части. Иначе возвращает false
+         */
+        inline bool fillFile(int & fd, off_t & offset, size_t & length) const {
+            if (head == nullptr || !head->isPerformed())
+                return false;
+            const FileRange & file = head->getResponseFile();
+            size_t prefix = head->getResponseHeader().size() + head->getResponseBody().size();
+            if (file.length == 0 || file.file->isInMemory() || sent < prefix)
+                return false;
+            fd = file.file->getFD();
+            offset = (off_t) (file.offset + sent - prefix);
+            length = file.length - (sent - prefix);
+            return true;
+        }
+
+        /*
+         * Отмечает n байт отправленными, полностью отправленные задачи извлекаются из очереди
+         * и передаются в release
+         */
+        template<typename F>
+        inline void consume(size_t n, F release) {
+            while (n > 0 && head) {
+                size_t rest = head->getResponseLength() - sent;
+                if (n < rest) {
+                    sent += n;
+                    return;
+                }
+                n -= rest;
+                release(pop());
+            }
+        }
+    };
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <string_view>
+#include <optional>
+#include <vector>
+
+namespace onyxup {
+
+    /*
+     * Заголовки, позиции которых запоминаются при добавлении в таблицу
+     */
+    enum class HttpHeader : uint8_t {
+        HOST,
+        CONNECTION,
+        CONTENT_LENGTH,
+        CONTENT_TYPE,
+        TRANSFER_ENCODING,
+        ACCEPT_ENCODING,
+        RANGE,
+        IF_NONE_MATCH,
+        IF_MODIFIED_SINCE,
+        COUNT
+    };
+
+    struct Header {
+        std::string_view name;
+        std::string_view value;
+    };
+
+    namespace header {
+
+        /*
+         * Переводит в нижний регистр буквы A-Z сразу в 8 байтах (SWAR), остальные байты не меняются
+         */
+        inline uint64_t toLowerAscii8(uint64_t x) {
+            uint64_t heptets = x & 0x7f7f7f7f7f7f7f7fULL;
+            uint64_t greater_z = heptets + 0x2525252525252525ULL;
+            uint64_t greater_equal_a = heptets + 0x3f3f3f3f3f3f3f3fULL;
+            uint64_t upper = ~x & (greater_equal_a ^ greater_z) & 0x8080808080808080ULL;
+            return x | (upper >> 2);
+        }
+
+        inline char toLowerAscii(char c) {
+            return (c >= 'A' && c <= 'Z') ? c | 0x20 : c;
+        }
+
+        /*
+         * Сравнение имен заголовков без учета регистра (только ASCII)
+         */
+        inline bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+            if (a.size() != b.size())
+                return false;
+            size_t i = 0;
+            for (; i + 8 <= a.size(); i += 8) {
+                uint64_t x, y;
+                memcpy(&x, a.data() + i, 8);
+                memcpy(&y, b.data() + i, 8);
+                if (toLowerAscii8(x) != toLowerAscii8(y))
+                    return false;
+            }
+            for (; i < a.size(); i++)
+                if (toLowerAscii(a[i]) != toLowerAscii(b[i]))
+                    return false;
+            return true;
+        }
+
+        /*
+         * Возвращает известный заголовок по имени или HttpHeader::COUNT
+         */
+        inline HttpHeader resolve(std::string_view name) {
+            switch (name.size()) {
+                case 4:
+                    if (equalsIgnoreCase(name, "host"))
+                        return HttpHeader::HOST;
+                    break;
+                case 5:
+                    if (equalsIgnoreCase(name, "range"))
+                        return HttpHeader::RANGE;
+                    break;
+                case 10:
+                    if (equalsIgnoreCase(name, "connection"))
+                        return HttpHeader::CONNECTION;
+                    break;
+                case 12:
+                    if (equalsIgnoreCase(name, "content-type"))
+                        return HttpHeader::CONTENT_TYPE;
+                    break;
+                case 13:
+                    if (equalsIgnoreCase(name, "if-none-match"))
+                        return HttpHeader::IF_NONE_MATCH;
+                    break;
+                case 14:
+                    if (equalsIgnoreCase(name, "content-length"))
+                        return HttpHeader::CONTENT_LENGTH;
+                    break;
+                case 15:
+                    if (equalsIgnoreCase(name, "accept-encoding"))
+                        return HttpHeader::ACCEPT_ENCODING;
+                    break;
+                case 17:
+                    if (equalsIgnoreCase(name, "transfer-encoding"))
+                        return HttpHeader::TRANSFER_ENCODING;
+                    if (equalsIgnoreCase(name, "if-modified-since"))
+                        return HttpHeader::IF_MODIFIED_SINCE;
+                    break;
+            }
+            return HttpHeader::COUNT;
+        }
+    }
+
+    /*
+     * Плоская таблица заголовков запроса. Первые INLINE_CAPACITY заголовков хранятся в самом объекте,
+     * при переполнении таблица целиком переезжает в vector. Поиск линейный без учета регистра,
+     * позиции известных заголовков (HttpHeader) запоминаются при добавлении.
+     * Имена и значения - view в буфер запроса, таблица ими не владеет
+     */
+    class HeaderTable {
+    public:
+        static constexpr size_t INLINE_CAPACITY = 24;
+    private:
+        Header items[INLINE_CAPACITY];
+        std::vector<Header> overflow;
+        bool spilled = false;
+        size_t count = 0;
+        /*
+         * Индекс известного заголовка + 1, 0 - заголовка нет
+         */
+        uint16_t known[(size_t) HttpHeader::COUNT] = {};
+
+        inline Header * data() {
+            return spilled ? overflow.data() : items;
+        }
+
+        inline const Header * data() const {
+            return spilled ? overflow.data() : items;
+        }
+
+        inline void spill() {
+            overflow.assign(items, items + count);
+            spilled = true;
+        }
+
+    public:
+
+        inline void add(std::string_view name, std::string_view value) {
+            HttpHeader id = header::resolve(name);
+            /*
+             * При повторе известного заголовка используется первое значение
+             */
+            if (id != HttpHeader::COUNT && known[(size_t) id] == 0)
+                known[(size_t) id] = count + 1;
+            if (!spilled && count < INLINE_CAPACITY)
+                items[count] = {name, value};
+            else {
+                if (!spilled)
+                    spill();
+                overflow.push_back({name, value});
+            }
+            count++;
+        }
+
+        inline std::optional<std::string_view> find(HttpHeader id) const noexcept {
+            uint16_t index = known[(size_t) id];
+            if (index == 0)
+                return std::nullopt;
+            return data()[index - 1].value;
+        }
+
+        inline std::optional<std::string_view> find(std::string_view name) const noexcept {
+            HttpHeader id = header::resolve(name);
+            if (id != HttpHeader::COUNT)
+                return find(id);
+            const Header * headers = data();
+            for (size_t i = 0; i < count; i++)
+                if (header::equalsIgnoreCase(headers[i].name, name))
+                    return headers[i].value;
+            return std::nullopt;
+        }
+
+        /*
+         * Заменяет значение заголовка, возвращает false, если заголовка нет
+         */
+        inline bool replace(std::string_view name, std::string_view value) {
+            Header * headers = data();
+            for (size_t i = 0; i < count; i++) {
+                if (header::equalsIgnoreCase(headers[i].name, name)) {
+                    headers[i].value = value;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline void reserve(size_t n) {
+            if (n > INLINE_CAPACITY && !spilled) {
+                overflow.reserve(n);
+                spill();
+            }
+        }
+
+        inline void clear() {
+            count = 0;
+            overflow.clear();
+            spilled = false;
+            memset(known, 0, sizeof(known));
+        }
+
+        inline size_t size() const {
+            return count;
+        }
+
+        inline bool empty() const {
+            return count == 0;
+        }
+
+        inline Header * begin() {
+            return data();
+        }
+
+        inline Header * end() {
+            return data() + count;
+        }
+
+        inline const Header * begin() const {
+            return data();
+        }
+
+        inline const Header * end() const {
+            return data() + count;
+        }
+    };
+}
@@ -1,5 +1,13 @@
+#include <string.h>
+#include <new>
+
 #include "request.h"
 
+/*
+ * Пустое поле тоже указывает на строку, завершенную нулевым символом
+ */
+static const std::string_view EMPTY_FIELD("", 0);
+
 onyxup::PtrRequest onyxup::req::requestFactory() {
     PtrRequest requets = new (std::nothrow) Request;
     if (requets) {
@@ -7,6 +15,14 @@ onyxup::PtrRequest onyxup::req::requestFactory() {
         requets->headerAccept = false;
         requets->bodyAccept = false;
         requets->bodyExists = false;
+        requets->keepAlive = false;
+        requets->setChunked(false);
+        requets->lastLengthInputBuffer = 0;
+        requets->headerLength = 0;
+        requets->contentLength = 0;
+        requets->storageLength = 0;
+        requets->storageCapacity = 0;
+        requets->fullUri = requets->uri = requets->method = requets->body = EMPTY_FIELD;
         return requets;
     }
     return nullptr;
@@ -16,30 +32,227 @@ void onyxup::Request::clear() {
     headerAccept = false;
     bodyAccept = false;
     bodyExists = false;
+    keepAlive = false;
+    setChunked(false);
+    lastLengthInputBuffer = 0;
+    headerLength = 0;
+    contentLength = 0;
 
-    fullUri.clear();
-    uri.clear();
-    method.clear();
-    body.clear();
+    /*
+     * Буфер storage остается за запросом и используется повторно
+     */
+    storageLength = 0;
+    fullUri = uri = method = body = EMPTY_FIELD;
     headers.clear();
     params.clear();
+    pathParams.clear();
+}
+
+void onyxup::Request::shrink(size_t maxCapacity) {
+    if (storageLength == 0 && storageCapacity > maxCapacity) {
+        storage.reset();
+        storageCapacity = 0;
+    }
 }
 
 onyxup::PtrRequest onyxup::req::requestCopyFactory(PtrRequest src) {
     PtrRequest dst = new (std::nothrow) Request;
     if (dst) {
-        *dst = *src;
+        dst->fd = src->fd;
+        dst->headerAccept = src->headerAccept;
+        dst->bodyAccept = src->bodyAccept;
+        dst->bodyExists = src->bodyExists;
+        dst->closingConnect = src->closingConnect;
+        dst->keepAlive = src->keepAlive;
+        dst->chunked = src->chunked;
+        dst->chunkedDecoder = src->chunkedDecoder;
+        dst->lastLengthInputBuffer = src->lastLengthInputBuffer;
+        dst->headerLength = src->headerLength;
+        dst->contentLength = src->contentLength;
+        dst->maxOutputBufferLength = src->maxOutputBufferLength;
+        dst->storageLength = 0;
+        dst->storageCapacity = 0;
+        dst->fullUri = src->fullUri;
+        dst->uri = src->uri;
+        dst->method = src->method;
+        dst->body = src->body;
+        dst->headers = src->headers;
+        dst->params = src->params;
+        dst->pathParams = src->pathParams;
+        if (src->storageLength > 0) {
+            dst->storage.reset(new (std::nothrow) char[src->storageLength]);
+            if (!dst->storage) {
+                delete dst;
+                return nullptr;
+            }
+            memcpy(dst->storage.get(), src->storage.get(), src->storageLength);
+            dst->storageLength = dst->storageCapacity = src->storageLength;
+            dst->rebase(src->storage.get(), src->storageLength, dst->storage.get());
+        }
         return dst;
     }
     return nullptr;
 }
 
-const std::string & onyxup::Request::getHeaderRef(const std::string & key) const {
-    return headers.at(key);
+onyxup::PtrRequest onyxup::req::requestMoveFactory(PtrRequest src) {
+    PtrRequest dst = requestFactory();
+    if (dst)
+        moveRequest(dst, src);
+    return dst;
+}
+
+void onyxup::req::moveRequest(PtrRequest dst, PtrRequest src) {
+    dst->clear();
+    dst->fd = src->fd;
+    dst->headerAccept = src->headerAccept;
+    dst->bodyAccept = src->bodyAccept;
+    dst->bodyExists = src->bodyExists;
+    dst->closingConnect = src->closingConnect;
+    dst->keepAlive = src->keepAlive;
+    dst->chunked = src->chunked;
+    dst->chunkedDecoder = src->chunkedDecoder;
+    dst->lastLengthInputBuffer = src->lastLengthInputBuffer;
+    dst->headerLength = src->headerLength;
+    dst->contentLength = src->contentLength;
+    dst->maxOutputBufferLength = src->maxOutputBufferLength;
+    /*
+     * Буферы меняются местами: вместе с storage к dst переходят указывающие в него поля,
+     * src получает пустой буфер dst для следующего запроса
+     */
+    std::swap(dst->storage, src->storage);
+    std::swap(dst->storageCapacity, src->storageCapacity);
+    dst->storageLength = src->storageLength;
+    dst->fullUri = src->fullUri;
+    dst->uri = src->uri;
+    dst->method = src->method;
+    dst->body = src->body;
+    std::swap(dst->headers, src->headers);
+    std::swap(dst->params, src->params);
+    std::swap(dst->pathParams, src->pathParams);
+    src->clear();
+}
+
+char * onyxup::Request::store(const char *data, size_t n) {
+    if (storageLength + n + 1 > storageCapacity) {
+        size_t capacity = storageCapacity * 2;
+        if (capacity < storageLength + n + 1)
+            capacity = storageLength + n + 1;
+        std::unique_ptr<char[]> buffer(new (std::nothrow) char[capacity]);
+        if (!buffer)
+            return nullptr;
+        if (storageLength > 0)
+            memcpy(buffer.get(), storage.get(), storageLength);
+        rebase(storage.get(), storageLength, buffer.get());
+        /*
+         * data может указывать в старый storage, поэтому он освобождается после копирования
+         */
+        memcpy(buffer.get() + storageLength, data, n);
+        storage = std::move(buffer);
+        storageCapacity = capacity;
+    } else
+        memmove(storage.get() + storageLength, data, n);
+    char *copy = storage.get() + storageLength;
+    copy[n] = '\0';
+    storageLength += n + 1;
+    return copy;
+}
+
+std::string_view onyxup::Request::own(std::string_view value) {
+    if (value.empty())
+        return EMPTY_FIELD;
+    const char *base = storage.get();
+    if (base && value.data() >= base && value.data() + value.size() <= base + storageLength)
+        return value;
+    char *copy = store(value.data(), value.size());
+    if (copy == nullptr)
+        return EMPTY_FIELD;
+    return std::string_view(copy, value.size());
+}
+
+bool onyxup::Request::setBody(const char *data, size_t n) {
+    std::string_view copy = own(std::string_view(data, n));
+    if (n > 0 && copy.empty())
+        return false;
+    body = copy;
+    return true;
+}
+
+void onyxup::Request::rebase(const char *oldBase, size_t oldLength, char *newBase) {
+    auto move = [oldBase, oldLength, newBase](std::string_view &view) {
+        if (!view.empty() && view.data() >= oldBase && view.data() < oldBase + oldLength)
+            view = std::string_view(newBase + (view.data() - oldBase), view.size());
+    };
+    if (oldBase == nullptr)
+        return;
+    move(fullUri);
+    move(uri);
+    move(method);
+    move(body);
+    for (auto &header : headers) {
+        move(header.name);
+        move(header.value);
+    }
+}
+
+int onyxup::Request::parseHeader(const char *data, size_t length, size_t lastLength, int &version) {
+    const char *method_ptr, *uri_ptr;
+    phr_header fields[100];
+    size_t method_len, uri_len;
+    size_t num_headers = sizeof(fields) / sizeof(fields[0]);
+    int result = phr_parse_request(data, length, &method_ptr, &method_len, &uri_ptr, &uri_len, &version,
+                                   fields, &num_headers, lastLength);
+    if (result <= 0)
+        return result;
+
+    /*
+     * Поля заголовка указывают в его копию, за каждым полем в заголовке идет разделитель
+     * (пробел, ':' или перевод строки), на его место записывается нулевой символ
+     */
+    char *base = store(data, result);
+    if (base == nullptr)
+        return -3;
+    auto field = [data, base](const char *ptr, size_t len) {
+        char *copy = base + (ptr - data);
+        copy[len] = '\0';
+        return copy;
+    };
+    method = std::string_view(field(method_ptr, method_len), method_len);
+    fullUri = std::string_view(field(uri_ptr, uri_len), uri_len);
+    headers.reserve(num_headers);
+    for (size_t i = 0; i < num_headers; i++) {
+        /*
+         * Продолжение предыдущего заголовка (obs-fold) пропускаем
+         */
+        if (fields[i].name == nullptr)
+            continue;
+        char *name = field(fields[i].name, fields[i].name_len);
+        char *value = field(fields[i].value, fields[i].value_len);
+        headers.add(std::string_view(name, fields[i].name_len), std::string_view(value, fields[i].value_len));
+    }
+    headerLength = result;
+    return result;
+}
+
+void onyxup::Request::addHeader(std::string_view key, std::string_view value) {
+    /*
+     * own может перенести storage вместе с уже добавленными в таблицу view,
+     * поэтому заголовок сначала добавляется, а потом заполняется
+     */
+    if (!headers.find(key))
+        headers.add(own(key), EMPTY_FIELD);
+    std::string_view copy = own(value);
+    headers.replace(key, copy);
+}
+
+std::string_view onyxup::Request::getHeaderRef(std::string_view key) const {
+    std::optional<std::string_view> value = headers.find(key);
+    if (!value)
+        throw std::out_of_range("Заголовок не найден");
+    return *value;
 }
 
-std::string onyxup::Request::getHeader(const std::string & key) const {
-    return headers.at(key);
+std::string onyxup::Request::getHeader(std::string_view key) const {
+    return std::string(getHeaderRef(key));
 }
 
 int onyxup::Request::getFD() const {
@@ -2,7 +2,14 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
 #include <unordered_map>
+#include <optional>
+
+#include "../httpparser/picohttpparser.h"
+#include "header-table.h"
 
 namespace onyxup {
     
@@ -14,33 +21,86 @@ namespace onyxup {
     namespace req {
         PtrRequest requestFactory();
         PtrRequest requestCopyFactory(PtrRequest);
+        PtrRequest requestMoveFactory(PtrRequest);
+        void moveRequest(PtrRequest dst, PtrRequest src);
     }
     
+    /*
+     * Метод, URI, заголовки и тело запроса - string_view в собственный буфер запроса storage,
+     * куда заголовок и тело копируются из входного буфера соединения один раз.
+     * Каждое поле в storage завершается нулевым символом.
+     * Запрос передается задаче целиком (moveRequest), без копирования полей
+     */
     class Request {
         friend PtrRequest req::requestFactory();
         friend PtrRequest req::requestCopyFactory(PtrRequest);
+        friend void req::moveRequest(PtrRequest, PtrRequest);
     private:
         int fd;
-        std::string fullUri;
-        std::string uri;
-        std::string method;
-        std::string body;
-        std::unordered_map<std::string, std::string> headers;
+        std::unique_ptr<char[]> storage;
+        size_t storageLength;
+        size_t storageCapacity;
+
+        std::string_view fullUri;
+        std::string_view uri;
+        std::string_view method;
+        std::string_view body;
+        HeaderTable headers;
         std::unordered_map<std::string, std::string> params;
+        std::unordered_map<std::string, std::string> pathParams;
         
         bool headerAccept;
         bool bodyAccept;
         bool bodyExists;
         bool closingConnect;
+        bool keepAlive;
+        bool chunked;
+
+        phr_chunked_decoder chunkedDecoder;
+
+        size_t lastLengthInputBuffer;
+        size_t headerLength;
+        size_t contentLength;
         
         size_t maxOutputBufferLength;
         
         Request(){};
+
+        /*
+         * Дописывает данные в storage и возвращает указатель на их копию.
+         * При увеличении storage все поля переносятся в новый буфер.
+         * Возвращает nullptr, если не удалось выделить память, storage при этом не меняется
+         */
+        char * store(const char * data, size_t n);
+
+        /*
+         * Возвращает view на данные в storage, данные вне storage предварительно копируются.
+         * Если память не выделена, возвращается пустое поле
+         */
+        std::string_view own(std::string_view value);
+
+        void rebase(const char * oldBase, size_t oldLength, char * newBase);
     public:
 
+        /*
+         * Разбирает заголовок запроса в data и копирует его в storage.
+         * Возвращает результат phr_parse_request или -3, если не удалось выделить память под копию
+         */
+        int parseHeader(const char * data, size_t length, size_t lastLength, int & version);
+
         int getFD() const;
 
         void clear();
+
+        /*
+         * Освобождает storage очищенного запроса, если его размер больше maxCapacity,
+         * чтобы запрос из пула не удерживал память после большого тела
+         */
+        void shrink(size_t maxCapacity);
+
+        inline size_t getStorageCapacity() const {
+            return storageCapacity;
+        }
         
         inline void setFD(int fd_) {
             fd = fd_;
@@ -54,32 +114,91 @@ namespace onyxup {
             headerAccept = accept;
         }
         
+        inline bool isKeepAlive() const {
+            return keepAlive;
+        }
+
+        inline void setKeepAlive(bool flag) {
+            keepAlive = flag;
+        }
+
+        inline bool isChunked() const {
+            return chunked;
+        }
+
+        /*
+         * Тело передается с Transfer-Encoding: chunked и декодируется по мере поступления,
+         * contentLength в этом случае - длина уже декодированной части
+         */
+        inline void setChunked(bool flag) {
+            chunked = flag;
+            chunkedDecoder = phr_chunked_decoder();
+            chunkedDecoder.consume_trailer = 1;
+        }
+
+        inline phr_chunked_decoder * getChunkedDecoder() {
+            return &chunkedDecoder;
+        }
+
+        inline size_t getLastLengthInputBuffer() const {
+            return lastLengthInputBuffer;
+        }
+
+        inline void setLastLengthInputBuffer(size_t n) {
+            lastLengthInputBuffer = n;
+        }
+
+        inline size_t getHeaderLength() const {
+            return headerLength;
+        }
+
+        inline void setHeaderLength(size_t n) {
+            headerLength = n;
+        }
+
+        inline size_t getContentLength() const {
+            return contentLength;
+        }
+
+        inline void setContentLength(size_t n) {
+            contentLength = n;
+        }
+
         inline void setFullURI(const char * uri, size_t n) {
-            fullUri = std::string(uri, n);
+            fullUri = own(std::string_view(uri, n));
         }
         
         inline void setMethod(const char * method, size_t n) {
-            this->method = std::string(method, n);
+            this->method = own(std::string_view(method, n));
         }
 
-        inline void addHeader(const std::string & key, const std::string & value){
-            headers[key] = value;
-        }
+        void addHeader(std::string_view key, std::string_view value);
         
         inline void addParam(const std::string & key, const std::string & value){
             params[key] = value;
         }
+
+        inline void addPathParam(const std::string & key, const std::string & value){
+            pathParams[key] = value;
+        }
         
-        inline const std::string & getFullURIRef() const {
+        /*
+         * URI вместе со строкой запроса, data() завершается нулевым символом
+         */
+        inline std::string_view getFullURIRef() const {
             return fullUri;
         }
 
         inline const std::string getFullURI() const {
-            return fullUri;
+            return std::string(fullUri);
+        }
+
+        inline std::string_view getMethodRef() const {
+            return method;
         }
         
         inline std::string getMethod() const {
-            return method;
+            return std::string(method);
         }
         
         inline bool isBodyAccept() const {
@@ -90,24 +209,25 @@ namespace onyxup {
             bodyAccept = accept;
         }
         
-        inline void setBody(const char* body, size_t n){
-            this->body = std::string(body, n);
-        }
+        /*
+         * Копирует тело в storage. Возвращает false, если не удалось выделить память
+         */
+        bool setBody(const char* body, size_t n);
         
-        const std::string & getURIRef() const {
+        std::string_view getURIRef() const {
             return uri;
         }
 
         std::string getURI() const {
-            return uri;
+            return std::string(uri);
         }
 
         bool isBodyExists(){
             return bodyExists;
         }
 
-        void setURI(const std::string & uri) {
-            this->uri = uri;
+        void setURI(std::string_view uri) {
+            this->uri = own(uri);
         }
 
         void setBodyExists(bool value){
@@ -122,21 +242,46 @@ namespace onyxup {
             maxOutputBufferLength = n;
         }
         
-        const std::string & getBodyRef() const {
+        std::string_view getBodyRef() const {
             return body;
         }
 
         std::string getBody() const {
-            return body;
+            return std::string(body);
         }
         
         const std::unordered_map<std::string, std::string> getParams() const {
             return params;
         }
+
+        /*
+         * Параметры пути из шаблона маршрута, например id для /users/{id:int}
+         */
+        const std::unordered_map<std::string, std::string> & getPathParams() const {
+            return pathParams;
+        }
         
-        const std::string & getHeaderRef(const std::string & key) const ;
+        /*
+         * Поиск заголовка без учета регистра имени, исключений не бросает
+         */
+        inline std::optional<std::string_view> findHeader(std::string_view key) const noexcept {
+            return headers.find(key);
+        }
+
+        inline std::optional<std::string_view> findHeader(HttpHeader header) const noexcept {
+            return headers.find(header);
+        }
+
+        /*
+         * Бросает std::out_of_range, если заголовка нет
+         */
+        std::string_view getHeaderRef(std::string_view key) const ;
+
+        inline const HeaderTable & getHeaders() const {
+            return headers;
+        }
 
-        std::string getHeader(const std::string & key) const;
+        std::string getHeader(std::string_view key) const;
 
         bool isClosingConnect() const;
 
@@ -0,0 +1,52 @@
+#include <string.h>
+
+#include "canned-responses.h"
+#include "http-date.h"
+#include "response-404.h"
+#include "response-408.h"
+#include "response-413.h"
+#include "response-503.h"
+
+void onyxup::CannedResponses::build(CannedResponse kind, bool closing, Entry &entry) {
+    ResponseBase response;
+    switch (kind) {
+        case CannedResponse::NOT_FOUND:
+            response = Response404();
+            break;
+        case CannedResponse::REQUEST_TIMEOUT:
+            response = Response408();
+            break;
+        case CannedResponse::PAYLOAD_TOO_LARGE:
+            response = Response413();
+            break;
+        case CannedResponse::SERVICE_UNAVAILABLE:
+        default:
+            response = Response503();
+            break;
+    }
+    response.addHeader("Content-Length", std::to_string(response.getBody().size()));
+    std::string header;
+    std::string body;
+    response.release(header, body, closing);
+    entry.code = response.getCode();
+    entry.dateOffset = header.find("\r\nDate: ") + sizeof("\r\nDate: ") - 1;
+    entry.header = std::make_shared<const std::string>(std::move(header));
+    entry.body = std::make_shared<const std::string>(std::move(body));
+}
+
+const onyxup::CannedResponses::Entry &onyxup::CannedResponses::get(CannedResponse kind) {
+    return get(kind, HttpDate::now());
+}
+
+const onyxup::CannedResponses::Entry &onyxup::CannedResponses::get(CannedResponse kind, std::string_view date,
+                                                                   bool closing) {
+    Entry &entry = entries[(size_t) kind][closing];
+    if (!entry.header)
+        build(kind, closing, entry);
+    if (entry.header->compare(entry.dateOffset, date.size(), date) != 0) {
+        std::string header = *entry.header;
+        header.replace(entry.dateOffset, date.size(), date.data(), date.size());
+        entry.header = std::make_shared<const std::string>(std::move(header));
+    }
+    return entry;
+}
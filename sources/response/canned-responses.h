@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace onyxup {
+
+    /*
+     * Ответы, которые реактор формирует сам
+     */
+    enum class CannedResponse : uint8_t {
+        NOT_FOUND,
+        REQUEST_TIMEOUT,
+        PAYLOAD_TOO_LARGE,
+        SERVICE_UNAVAILABLE,
+        COUNT
+    };
+
+    /*
+     * Заранее сформированные ответы реактора (404, 408, 413, 503). Заголовок и тело собираются
+     * один раз при первом обращении (отдельно для Connection: Keep-Alive и Connection: close)
+     * и дальше отправляются по ссылке. Строки неизменяемы:
+     * при смене секунды создается новая копия заголовка с актуальной датой, а задачи, стоящие
+     * в очереди на отправку, продолжают держать старую.
+     * Не потокобезопасен - используется только потоком своего реактора
+     */
+    class CannedResponses {
+    public:
+        struct Entry {
+            int code = 0;
+            std::shared_ptr<const std::string> header;
+            std::shared_ptr<const std::string> body;
+            size_t dateOffset = 0;
+        };
+    private:
+        Entry entries[(size_t) CannedResponse::COUNT][2];
+
+        void build(CannedResponse kind, bool closing, Entry & entry);
+    public:
+
+        const Entry & get(CannedResponse kind);
+
+        /*
+         * Ответ с датой date (HttpDate::LENGTH символов) вместо текущей.
+         * closing - соединение закрывается после ответа
+         */
+        const Entry & get(CannedResponse kind, std::string_view date, bool closing = false);
+    };
+}
@@ -4,35 +4,29 @@
 #include "../../gzip/compress.hpp"
 
 static bool checkSupportGzipEncoding(onyxup::PtrTask task) {
-    try {
-        if (task->getRequest()->getHeaderRef("accept-encoding").find("gzip") != std::string::npos)
-            return true;
-    } catch (std::out_of_range &ex) {
-        return false;
-    }
+    std::optional<std::string_view> accept_encoding = task->getRequest()->findHeader(onyxup::HttpHeader::ACCEPT_ENCODING);
+    return accept_encoding && accept_encoding->find("gzip") != std::string_view::npos;
 }
 
 static void prepareCompressResponse(onyxup::ResponseBase &response) {
+    response.loadFile();
     response.addHeader("Content-Encoding", "gzip");
     std::string compressed_body = gzip::compress(response.getBody().c_str(), response.getBody().size());
-    response.setBody(compressed_body);
+    response.setBody(std::move(compressed_body));
     response.addHeader("Content-Length", std::to_string(response.getBody().size()));
 }
 
 namespace onyxup {
+    /*
+     * Сжимает ответы обработчиков, запросивших сжатие. Статические ресурсы сжимаются заранее
+     * (HttpServer::defaultStaticResourcesCallback) и здесь не обрабатываются
+     */
     class ResponsePrepareCompressChain : public IResponsePrepareChain {
-    private:
-        bool compressStaticResources;
     public:
         
-        ResponsePrepareCompressChain(bool flag = false) : IResponsePrepareChain(), compressStaticResources(flag){
-        }
-        
         virtual void execute(PtrTask task, onyxup::ResponseBase &response) override {
             if(checkSupportGzipEncoding(task) && response.isCompress())
                 prepareCompressResponse(response);
-            else if(task->getType() == EnumTaskType::STATIC_RESOURCES_TASK && compressStaticResources)
-                prepareCompressResponse(response);
             else {
                 if (nextChain != nullptr)
                     nextChain->execute(task, response);
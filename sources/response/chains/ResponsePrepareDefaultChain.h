@@ -3,7 +3,7 @@
 #include "IResponsePrepareChain.h"
 
 static void prepareDefaultResponse(onyxup::ResponseBase &response) {
-    response.addHeader("Content-Length", std::to_string(response.getBody().size()));
+    response.addHeader("Content-Length", std::to_string(response.getContentLength()));
 }
 
 namespace onyxup {
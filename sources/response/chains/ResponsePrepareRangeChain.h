@@ -6,17 +6,13 @@
 #include "../../mime/types.h"
 
 static bool checkRequestRange(onyxup::PtrTask task) {
-    try {
-        if (task->getRequest()->getHeaderRef("range").find("bytes") != std::string::npos)
-            return true;
-    } catch (std::out_of_range &ex) {
-        return false;
-    }
+    std::optional<std::string_view> range = task->getRequest()->findHeader(onyxup::HttpHeader::RANGE);
+    return range && range->find("bytes") != std::string_view::npos;
 }
 
 void static prepareRangeNotSatisfiableResponse(onyxup::ResponseBase &response) {
     std::ostringstream os;
-    os << "*/" << response.getBody().size();
+    os << "*/" << response.getContentLength();
     response.setCode(onyxup::ResponseState::RESPONSE_STATE_RANGE_NOT_SATISFIABLE_CODE);
     response.setCodeMsg(onyxup::ResponseState::RESPONSE_STATE_RANGE_NOT_SATISFIABLE_MSG);
     response.addHeader("Content-Range", os.str());
@@ -24,7 +20,20 @@ void static prepareRangeNotSatisfiableResponse(onyxup::ResponseBase &response) {
 }
 
 static void prepareRangeResponse(onyxup::ResponseBase &response, std::vector<std::pair<size_t, size_t>> &ranges) {
-    if (ranges.size() == 1) {
+    if (ranges.size() == 1 && response.getFile().file != nullptr) {
+        /*
+         * Тело из файла не читаем - отправляем только нужную часть файла
+         */
+        std::ostringstream os;
+        os << "bytes " << ranges[0].first << "-" << ranges[0].second << "/"
+           << response.getContentLength();
+        size_t length = ranges[0].second - ranges[0].first + 1;
+        response.setCode(onyxup::ResponseState::RESPONSE_STATE_PARTIAL_CONTENT_CODE);
+        response.setCodeMsg(onyxup::ResponseState::RESPONSE_STATE_PARTIAL_CONTENT_MSG);
+        response.addHeader("Content-Range", os.str());
+        response.addHeader("Content-Length", std::to_string(length));
+        response.setFileRange(response.getFile().offset + ranges[0].first, length);
+    } else if (ranges.size() == 1) {
         std::string body;
         std::copy(response.getBody().begin() + ranges[0].first,
                   response.getBody().begin() + ranges[0].second + 1,
@@ -36,8 +45,9 @@ static void prepareRangeResponse(onyxup::ResponseBase &response, std::vector<std
         response.setCodeMsg(onyxup::ResponseState::RESPONSE_STATE_PARTIAL_CONTENT_MSG);
         response.addHeader("Content-Range", os.str());
         response.addHeader("Content-Length", std::to_string(body.size()));
-        response.setBody(body);
+        response.setBody(std::move(body));
     } else {
+        response.loadFile();
         size_t length_body = response.getBody().size();
         const char *content_type_body = response.getMimeType();
         std::ostringstream os;
@@ -68,7 +78,7 @@ namespace onyxup {
             if (checkRequestRange(task)) {
                 try {
                     std::vector<std::pair<size_t, size_t>> ranges = utils::parseRangesRequest(
-                            task->getRequest()->getHeaderRef("range"), response.getBody().size() - 1);
+                            std::string(*task->getRequest()->findHeader(HttpHeader::RANGE)), response.getContentLength() - 1);
                     prepareRangeResponse(response, ranges);
                 } catch (OnyxupException &ex) {
                     prepareRangeNotSatisfiableResponse(response);
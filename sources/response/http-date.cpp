@@ -0,0 +1,86 @@
+#include <string.h>
+
+#include "http-date.h"
+
+static const char DAYS[7][4] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char MONTHS[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+static inline char * writeTwoDigits(char * out, int value) {
+    out[0] = '0' + value / 10;
+    out[1] = '0' + value % 10;
+    return out + 2;
+}
+
+static inline char * writeName(char * out, const char * name) {
+    out[0] = name[0];
+    out[1] = name[1];
+    out[2] = name[2];
+    return out + 3;
+}
+
+void onyxup::HttpDate::format(time_t time, char * out) {
+    struct tm tm;
+    gmtime_r(&time, &tm);
+    int year = tm.tm_year + 1900;
+    out = writeName(out, DAYS[tm.tm_wday]);
+    *out++ = ',';
+    *out++ = ' ';
+    out = writeTwoDigits(out, tm.tm_mday);
+    *out++ = ' ';
+    out = writeName(out, MONTHS[tm.tm_mon]);
+    *out++ = ' ';
+    out = writeTwoDigits(out, year / 100 % 100);
+    out = writeTwoDigits(out, year % 100);
+    *out++ = ' ';
+    out = writeTwoDigits(out, tm.tm_hour);
+    *out++ = ':';
+    out = writeTwoDigits(out, tm.tm_min);
+    *out++ = ':';
+    out = writeTwoDigits(out, tm.tm_sec);
+    memcpy(out, " GMT", 4);
+}
+
+static inline bool readDigits(std::string_view src, size_t pos, size_t count, int & value) {
+    value = 0;
+    for (size_t i = pos; i < pos + count; i++) {
+        if (src[i] < '0' || src[i] > '9')
+            return false;
+        value = value * 10 + (src[i] - '0');
+    }
+    return true;
+}
+
+bool onyxup::HttpDate::parse(std::string_view date, time_t & time) {
+    if (date.size() != LENGTH || date.compare(3, 2, ", ") != 0 || date.compare(25, 4, " GMT") != 0 ||
+        date[7] != ' ' || date[11] != ' ' || date[16] != ' ' || date[19] != ':' || date[22] != ':')
+        return false;
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    int year;
+    if (!readDigits(date, 5, 2, tm.tm_mday) || !readDigits(date, 12, 4, year) ||
+        !readDigits(date, 17, 2, tm.tm_hour) || !readDigits(date, 20, 2, tm.tm_min) ||
+        !readDigits(date, 23, 2, tm.tm_sec))
+        return false;
+    tm.tm_mon = -1;
+    for (int i = 0; i < 12; i++) {
+        if (date.compare(8, 3, MONTHS[i]) == 0)
+            tm.tm_mon = i;
+    }
+    if (tm.tm_mon == -1)
+        return false;
+    tm.tm_year = year - 1900;
+    time = timegm(&tm);
+    return true;
+}
+
+std::string_view onyxup::HttpDate::now() {
+    thread_local time_t cachedTime = -1;
+    thread_local char cached[LENGTH];
+    time_t current = time(nullptr);
+    if (current != cachedTime) {
+        format(current, cached);
+        cachedTime = current;
+    }
+    return std::string_view(cached, LENGTH);
+}
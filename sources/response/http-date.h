@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stddef.h>
+#include <time.h>
+#include <string_view>
+
+namespace onyxup {
+
+    /*
+     * Дата для заголовков HTTP в формате IMF-fixdate (RFC 7231), например
+     * "Sun, 06 Nov 1994 08:49:37 GMT"
+     */
+    class HttpDate {
+    public:
+        static constexpr size_t LENGTH = 29;
+
+        /*
+         * Записывает в out ровно LENGTH символов (без завершающего нуля)
+         */
+        static void format(time_t time, char * out);
+
+        /*
+         * Разбирает дату в формате IMF-fixdate. Возвращает false, если формат другой
+         */
+        static bool parse(std::string_view date, time_t & time);
+
+        /*
+         * Текущая дата. Строка кэшируется в каждом потоке и форматируется заново
+         * не чаще раза в секунду. View действителен до следующего вызова в этом потоке
+         */
+        static std::string_view now();
+    };
+}
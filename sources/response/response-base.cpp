@@ -1,55 +1,75 @@
 #include "response-base.h"
+#include "response-writer.h"
 
 std::string onyxup::ResponseBase::SERVER_IP = "";
 int onyxup::ResponseBase::SERVER_PORT = 80;
 
+void onyxup::ResponseBase::setServerAddress(const std::string &ip, int port) {
+    SERVER_IP = ip;
+    SERVER_PORT = port;
+    ResponseWriter::setServerAddress(ip, port);
+}
+
+void onyxup::ResponseBase::prepareHeader(std::string &out, bool closing) {
+    ResponseWriter writer(out, false, closing);
+    writer.status(code, codeMsg);
+    writer.header("Content-Type", mimeType);
+    for (auto &header : m_headers)
+        writer.header(header.first, header.second);
+    writer.finishHeader();
+}
+
 std::string onyxup::ResponseBase::prepareResponse() {
-    char buffer [4096];
-    std::ostringstream os;
-
-    for(auto header : m_headers)
-        os << "\r\n" << header.first << ": " << header.second;
-
-    struct tm tm;
-    std::chrono::time_point<std::chrono::system_clock> date =  std::chrono::system_clock::now();
-    std::time_t  time = std::chrono::system_clock::to_time_t(date);
-    memset(&tm, 0, sizeof(tm));
-    localtime_r(&time, &tm);
-    char datetime[80];
-    memset(datetime, '\0', sizeof (datetime));
-    strftime(datetime, sizeof (datetime), "%Y-%m-%d %H:%M:%S", &tm);
-
-    snprintf(buffer, sizeof(buffer), ResponseBase::HEADER, code, codeMsg, SERVER_IP.c_str(), SERVER_PORT, VERSION_APPLICATION, datetime, mimeType, os.str().c_str());
-    header = std::string(buffer);
+    loadFile();
+    prepareHeader(header);
     return header + body;
 }
 
-onyxup::ResponseBase::ResponseBase(onyxup::ResponseBase && src) {
-    code = src.code;
-    mimeType = src.mimeType;
-    codeMsg = src.codeMsg;
-    compress = src.compress;
-    header = std::move(src.header);
-    body = std::move(src.body);
-    header = std::move(src.header);
-}
-
-onyxup::ResponseBase& onyxup::ResponseBase::operator=(onyxup::ResponseBase && src) {
-    if (&src == this)
-        return *this;
-    delete this;
-    code = src.code;
-    mimeType = src.mimeType;
-    codeMsg = src.codeMsg;
-    compress = src.compress;
-    header = std::move(src.header);
-    body = std::move(src.body);
-    header = std::move(src.header);
-    return *this;
-}
-
-void onyxup::ResponseBase::setBody(const std::string &body) {
-    this->body = body;
+void onyxup::ResponseBase::release(std::string &header, std::string &body, bool closing) {
+    prepareHeader(header, closing);
+    body = std::move(this->body);
+    this->body.clear();
+}
+
+void onyxup::ResponseBase::setBody(std::string body) {
+    this->body = std::move(body);
+    file = FileRange();
+}
+
+void onyxup::ResponseBase::setFile(PtrStaticFile file) {
+    body.clear();
+    size_t size = file ? file->getSize() : 0;
+    this->file.file = std::move(file);
+    this->file.offset = 0;
+    this->file.length = size;
+}
+
+void onyxup::ResponseBase::setFileRange(size_t offset, size_t length) {
+    file.offset = offset;
+    file.length = length;
+}
+
+const onyxup::FileRange &onyxup::ResponseBase::getFile() const {
+    return file;
+}
+
+onyxup::FileRange onyxup::ResponseBase::releaseFile() {
+    FileRange range = std::move(file);
+    file = FileRange();
+    return range;
+}
+
+void onyxup::ResponseBase::loadFile() {
+    if (file.file == nullptr)
+        return;
+    if (!file.file->read(file.offset, file.length, body)) {
+        LOGE << "Ошибка чтения файла статического ресурса, прочитано " << body.size() << " из " << file.length;
+    }
+    file = FileRange();
+}
+
+size_t onyxup::ResponseBase::getContentLength() const {
+    return body.size() + file.length;
 }
 
 void onyxup::ResponseBase::addHeader(const std::string &key, const std::string &value) {
@@ -13,6 +13,7 @@
 #include "../gzip/version.hpp"
 #include "../version.h"
 #include "../plog/Log.h"
+#include "../static/static-file.h"
 
 namespace onyxup {
     
@@ -21,22 +22,32 @@ namespace onyxup {
 
         std::string header;
         std::string body;
-        int code;
-        const char * codeMsg;
-        const char * mimeType;
-        bool compress;
+        /*
+         * Тело ответа из файла: реактор отправляет его через sendfile, в память оно не читается
+         */
+        FileRange file;
+        int code = 0;
+        const char * codeMsg = "";
+        const char * mimeType = "";
+        bool compress = false;
         std::unordered_map<std::string, std::string> m_headers;
 
         std::string prepareResponse();
 
-        static constexpr const char *HEADER = "HTTP/1.1 %d %s\r\nHost: %s:%d\r\nServer: onyxup/%s\r\nConnection: Keep-Alive\r\nDate: %s\r\nAccept-Ranges: bytes\r\nContent-Type: %s%s\r\n\r\n";
+        void prepareHeader(std::string & out, bool closing = false);
+
 
     public:
         
         static std::string SERVER_IP;
         static int SERVER_PORT;
 
-        ResponseBase(int code, const char *codeMsg, const char *mime, const std::string &body, bool compress = false) : code(code), codeMsg(codeMsg), mimeType(mime), body(body), compress(compress){
+        /*
+         * Задает адрес сервера для заголовка Host, вызывается до начала обработки запросов
+         */
+        static void setServerAddress(const std::string & ip, int port);
+
+        ResponseBase(int code, const char *codeMsg, const char *mime, std::string body, bool compress = false) : body(std::move(body)), code(code), codeMsg(codeMsg), mimeType(mime), compress(compress){
         }
 
         ResponseBase(int code, const char *codeMsg, const char *mime, bool compress = false): ResponseBase(code, codeMsg, mime, "", compress){
@@ -48,8 +59,8 @@ namespace onyxup {
         ResponseBase(const ResponseBase &) = default;
         ResponseBase & operator=(const ResponseBase &) = default;
 
-        ResponseBase(ResponseBase &&);
-        ResponseBase & operator=(ResponseBase &&);
+        ResponseBase(ResponseBase &&) = default;
+        ResponseBase & operator=(ResponseBase &&) = default;
 
         operator std::string() {
             return prepareResponse();
@@ -59,9 +70,45 @@ namespace onyxup {
             return prepareResponse();
         }
 
+        /*
+         * Записывает в header заголовок ответа, а тело передает в body без копирования.
+         * После вызова тело ответа пустое. closing - соединение закрывается после ответа
+         */
+        void release(std::string & header, std::string & body, bool closing = false);
+
         const char *getMimeType() const;
 
-        void setBody(const std::string &body);
+        /*
+         * Заменяет тело ответа, тело из файла при этом сбрасывается
+         */
+        void setBody(std::string body);
+
+        /*
+         * Делает телом ответа файл целиком
+         */
+        void setFile(PtrStaticFile file);
+
+        /*
+         * Оставляет в теле из файла length байт с позиции offset (относительно начала файла)
+         */
+        void setFileRange(size_t offset, size_t length);
+
+        const FileRange & getFile() const;
+
+        /*
+         * Передает тело из файла в задачу, после вызова ответ его не содержит
+         */
+        FileRange releaseFile();
+
+        /*
+         * Читает тело из файла в память, нужно там, где с телом работают как со строкой (сжатие, multipart)
+         */
+        void loadFile();
+
+        /*
+         * Длина тела ответа с учетом тела из файла
+         */
+        size_t getContentLength() const;
 
         void addHeader(const std::string &key, const std::string &value);
 
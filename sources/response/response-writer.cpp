@@ -0,0 +1,219 @@
+#include <string.h>
+
+#include "response-writer.h"
+#include "response-states.h"
+#include "http-date.h"
+#include "../request/header-table.h"
+#include "../version.h"
+
+static std::string buildHeaderPrefix(const std::string &ip, int port) {
+    return "Host: " + ip + ":" + std::to_string(port) + "\r\nServer: onyxup/" + VERSION_APPLICATION +
+           "\r\nAccept-Ranges: bytes\r\n";
+}
+
+static std::string headerPrefix = buildHeaderPrefix("", 80);
+
+static std::string buildStatusLine(int code, const char *msg) {
+    return "HTTP/1.1 " + std::to_string(code) + " " + msg + "\r\n";
+}
+
+namespace {
+    /*
+     * Строки статуса для кодов из ResponseState, индекс - код ответа
+     */
+    struct StatusLines {
+        static constexpr int MIN_CODE = 100;
+        static constexpr int MAX_CODE = 599;
+
+        const char *messages[MAX_CODE - MIN_CODE + 1] = {};
+        std::string lines[MAX_CODE - MIN_CODE + 1];
+
+        StatusLines();
+
+        inline const std::string *find(int code, const char *msg) const {
+            if (code < MIN_CODE || code > MAX_CODE)
+                return nullptr;
+            const char *known = messages[code - MIN_CODE];
+            if (known == nullptr || (known != msg && strcmp(known, msg) != 0))
+                return nullptr;
+            return &lines[code - MIN_CODE];
+        }
+    };
+
+    StatusLines::StatusLines() {
+        using onyxup::ResponseState;
+        static const std::pair<int, const char *> states[] = {
+            {ResponseState::RESPONSE_STATE_CONTINUE_CODE, ResponseState::RESPONSE_STATE_CONTINUE_MSG},
+            {ResponseState::RESPONSE_STATE_SWITCHING_PROTOCOLS_CODE, ResponseState::RESPONSE_STATE_SWITCHING_PROTOCOLS_MSG},
+            {ResponseState::RESPONSE_STATE_PROCESSING_CODE, ResponseState::RESPONSE_STATE_PROCESSING_MSG},
+            {ResponseState::RESPONSE_STATE_OK_CODE, ResponseState::RESPONSE_STATE_OK_MSG},
+            {ResponseState::RESPONSE_STATE_CREATED_CODE, ResponseState::RESPONSE_STATE_CREATED_MSG},
+            {ResponseState::RESPONSE_STATE_ACCEPTED_CODE, ResponseState::RESPONSE_STATE_ACCEPTED_MSG},
+            {ResponseState::RESPONSE_STATE_NON_CODE, ResponseState::RESPONSE_STATE_NON_MSG},
+            {ResponseState::RESPONSE_STATE_NO_CONTENT_CODE, ResponseState::RESPONSE_STATE_NO_CONTENT_MSG},
+            {ResponseState::RESPONSE_STATE_RESET_CONTENT_CODE, ResponseState::RESPONSE_STATE_RESET_CONTENT_MSG},
+            {ResponseState::RESPONSE_STATE_PARTIAL_CONTENT_CODE, ResponseState::RESPONSE_STATE_PARTIAL_CONTENT_MSG},
+            {ResponseState::RESPONSE_STATE_MULTI_STATUS_CODE, ResponseState::RESPONSE_STATE_MULTI_STATUS_MSG},
+            {ResponseState::RESPONSE_STATE_ALREADY_REPORTED_CODE, ResponseState::RESPONSE_STATE_ALREADY_REPORTED_MSG},
+            {ResponseState::RESPONSE_STATE_IM_USED_CODE, ResponseState::RESPONSE_STATE_IM_USED_MSG},
+            {ResponseState::RESPONSE_STATE_MULTIPLE_CHOICES_CODE, ResponseState::RESPONSE_STATE_MULTIPLE_CHOICES_MSG},
+            {ResponseState::RESPONSE_STATE_MOVED_PERMANENTLY_CODE, ResponseState::RESPONSE_STATE_MOVED_PERMANENTLY_MSG},
+            {ResponseState::RESPONSE_STATE_MOVED_TEMPORARILY_CODE, ResponseState::RESPONSE_STATE_MOVED_TEMPORARILY_MSG},
+            {ResponseState::RESPONSE_STATE_SEE_OTHER_CODE, ResponseState::RESPONSE_STATE_SEE_OTHER_MSG},
+            {ResponseState::RESPONSE_STATE_NOT_MODIFIED_CODE, ResponseState::RESPONSE_STATE_NOT_MODIFIED_MSG},
+            {ResponseState::RESPONSE_STATE_USE_PROXY_CODE, ResponseState::RESPONSE_STATE_USE_PROXY_MSG},
+            {ResponseState::RESPONSE_STATE_TEMPORARY_REDIRECT_CODE, ResponseState::RESPONSE_STATE_TEMPORARY_REDIRECT_MSG},
+            {ResponseState::RESPONSE_STATE_PERMANENT_REDIRECT_CODE, ResponseState::RESPONSE_STATE_PERMANENT_REDIRECT_MSG},
+            {ResponseState::RESPONSE_STATE_BAD_REQUEST_CODE, ResponseState::RESPONSE_STATE_BAD_REQUEST_MSG},
+            {ResponseState::RESPONSE_STATE_UNAUTHORIZED_CODE, ResponseState::RESPONSE_STATE_UNAUTHORIZED_MSG},
+            {ResponseState::RESPONSE_STATE_PAYMENT_REQUIRED_CODE, ResponseState::RESPONSE_STATE_PAYMENT_REQUIRED_MSG},
+            {ResponseState::RESPONSE_STATE_FORBIDDEN_CODE, ResponseState::RESPONSE_STATE_FORBIDDEN_MSG},
+            {ResponseState::RESPONSE_STATE_NOT_FOUND_CODE, ResponseState::RESPONSE_STATE_NOT_FOUND_MSG},
+            {ResponseState::RESPONSE_STATE_METHOD_NOT_ALLOWED_CODE, ResponseState::RESPONSE_STATE_METHOD_NOT_ALLOWED_MSG},
+            {ResponseState::RESPONSE_STATE_METHOD_NOT_ACCEPTABLE_CODE, ResponseState::RESPONSE_STATE_METHOD_NOT_ACCEPTABLE_MSG},
+            {ResponseState::RESPONSE_STATE_METHOD_PROXY_AUTHENTICATION_REQUIRED_CODE, ResponseState::RESPONSE_STATE_METHOD_PROXY_AUTHENTICATION_REQUIRED_MSG},
+            {ResponseState::RESPONSE_STATE_METHOD_REQUEST_TIMEOUT_CODE, ResponseState::RESPONSE_STATE_METHOD_REQUEST_TIMEOUT_MSG},
+            {ResponseState::RESPONSE_STATE_METHOD_CONFLICT_CODE, ResponseState::RESPONSE_STATE_METHOD_CONFLICT_MSG},
+            {ResponseState::RESPONSE_STATE_METHOD_GONE_CODE, ResponseState::RESPONSE_STATE_METHOD_GONE_MSG},
+            {ResponseState::RESPONSE_STATE_LENGTH_REQUIRED_CODE, ResponseState::RESPONSE_STATE_METHOD_LENGTH_REQUIRED_MSG},
+            {ResponseState::RESPONSE_STATE_PRECONDITION_FAILED_CODE, ResponseState::RESPONSE_STATE_METHOD_PRECONDITION_FAILED_MSG},
+            {ResponseState::RESPONSE_STATE_PAYLOAD_TOO_LARGE_CODE, ResponseState::RESPONSE_STATE_METHOD_PAYLOAD_TOO_LARGE_MSG},
+            {ResponseState::RESPONSE_STATE_URI_TOO_LONG_CODE, ResponseState::RESPONSE_STATE_METHOD_URI_TOO_LONG_MSG},
+            {ResponseState::RESPONSE_STATE_UNSUPPORTED_MEDIA_TYPE_CODE, ResponseState::RESPONSE_STATE_UNSUPPORTED_MEDIA_TYPE_MSG},
+            {ResponseState::RESPONSE_STATE_RANGE_NOT_SATISFIABLE_CODE, ResponseState::RESPONSE_STATE_RANGE_NOT_SATISFIABLE_MSG},
+            {ResponseState::RESPONSE_STATE_EXPECTATION_FAILED_CODE, ResponseState::RESPONSE_STATE_EXPECTATION_FAILED_MSG},
+            {ResponseState::RESPONSE_STATE_IM_TEAPOT_CODE, ResponseState::RESPONSE_STATE_IM_TEAPOT_MSG},
+            {ResponseState::RESPONSE_STATE_AUTHENTICATION_TIMEOUT_CODE, ResponseState::RESPONSE_STATE_AUTHENTICATION_TIMEOUT_MSG},
+            {ResponseState::RESPONSE_STATE_MISDIRECTED_REQUEST_CODE, ResponseState::RESPONSE_STATE_MISDIRECTED_REQUEST_MSG},
+            {ResponseState::RESPONSE_STATE_UNPROCESSABLE_ENTITY_CODE, ResponseState::RESPONSE_STATE_UNPROCESSABLE_ENTITY_MSG},
+            {ResponseState::RESPONSE_STATE_LOCKED_CODE, ResponseState::RESPONSE_STATE_LOCKED_MSG},
+            {ResponseState::RESPONSE_STATE_FAILED_DEPENDENCY_CODE, ResponseState::RESPONSE_STATE_FAILED_DEPENDENCY_MSG},
+            {ResponseState::RESPONSE_STATE_UPGRADE_REQUIRED_CODE, ResponseState::RESPONSE_STATE_UPGRADE_REQUIRED_MSG},
+            {ResponseState::RESPONSE_STATE_PRECONDITION_REQUIRED_CODE, ResponseState::RESPONSE_STATE_PRECONDITION_REQUIRED_MSG},
+            {ResponseState::RESPONSE_STATE_TOO_MANY_REQUEST_CODE, ResponseState::RESPONSE_STATE_TOO_MANY_REQUEST_MSG},
+            {ResponseState::RESPONSE_STATE_REQUEST_HEADER_FIELDS_TOO_LARGE_CODE, ResponseState::RESPONSE_STATE_REQUEST_HEADER_FIELDS_TOO_LARGE_MSG},
+            {ResponseState::RESPONSE_STATE_RETRY_WITH_CODE, ResponseState::RESPONSE_STATE_RETRY_WITH_MSG},
+            {ResponseState::RESPONSE_STATE_UNAVAILABLE_FOR_LEGAL_REASONS_CODE, ResponseState::RESPONSE_STATE_UNAVAILABLE_FOR_LEGAL_REASONS_MSG},
+            {ResponseState::RESPONSE_STATE_CLIENT_CLOSED_REQUEST_CODE, ResponseState::RESPONSE_STATE_CLIENT_CLOSED_REQUEST_MSG},
+            {ResponseState::RESPONSE_STATE_INTERNAL_SERVER_ERROR_CODE, ResponseState::RESPONSE_STATE_INTERNAL_SERVER_ERROR_MSG},
+            {ResponseState::RESPONSE_STATE_NOT_IMPLEMENTED_CODE, ResponseState::RESPONSE_STATE_NOT_IMPLEMENTED_MSG},
+            {ResponseState::RESPONSE_STATE_BAD_GATEWAY_CODE, ResponseState::RESPONSE_STATE_BAD_GATEWAY_MSG},
+            {ResponseState::RESPONSE_STATE_SERVICE_UNAVAILABLE_CODE, ResponseState::RESPONSE_STATE_SERVICE_UNAVAILABLE_MSG},
+            {ResponseState::RESPONSE_STATE_GATEWAY_TIMEOUT_CODE, ResponseState::RESPONSE_STATE_GATEWAY_TIMEOUT_MSG},
+            {ResponseState::RESPONSE_STATE_HTTP_VERSION_NOT_SUPPORTED_CODE, ResponseState::RESPONSE_STATE_HTTP_VERSION_NOT_SUPPORTED_MSG},
+            {ResponseState::RESPONSE_STATE_VARIANT_ALSO_NEGOTIATES_CODE, ResponseState::RESPONSE_STATE_VARIANT_ALSO_NEGOTIATES_MSG},
+            {ResponseState::RESPONSE_STATE_INSUFFICIENT_STORAGE_CODE, ResponseState::RESPONSE_STATE_INSUFFICIENT_STORAGE_MSG},
+            {ResponseState::RESPONSE_STATE_LOOP_DETECTED_CODE, ResponseState::RESPONSE_STATE_LOOP_DETECTED_MSG},
+            {ResponseState::RESPONSE_STATE_BANDWIDTH_LIMIT_EXCEEDED_CODE, ResponseState::RESPONSE_STATE_BANDWIDTH_LIMIT_EXCEEDED_MSG},
+            {ResponseState::RESPONSE_STATE_NOT_EXTENDED_CODE, ResponseState::RESPONSE_STATE_NOT_EXTENDED_MSG},
+            {ResponseState::RESPONSE_STATE_NETWORK_AUTHENTICATION_REQUIRED_CODE, ResponseState::RESPONSE_STATE_NETWORK_AUTHENTICATION_REQUIRED_MSG},
+            {ResponseState::RESPONSE_STATE_UNKNOWN_ERROR_CODE, ResponseState::RESPONSE_STATE_UNKNOWN_ERROR_MSG},
+            {ResponseState::RESPONSE_STATE_WEB_SERVER_IS_DOWN_CODE, ResponseState::RESPONSE_STATE_WEB_SERVER_IS_DOWN_MSG},
+            {ResponseState::RESPONSE_STATE_CONNECTION_TIMEOUT_CODE, ResponseState::RESPONSE_STATE_CONNECTION_TIMEOUT_MSG},
+            {ResponseState::RESPONSE_STATE_ORIGIN_IS_UNREACHABLE_CODE, ResponseState::RESPONSE_STATE_ORIGIN_IS_UNREACHABLE_MSG},
+            {ResponseState::RESPONSE_STATE_TIMEOUT_OCCURRED_CODE, ResponseState::RESPONSE_STATE_TIMEOUT_OCCURRED_MSG},
+            {ResponseState::RESPONSE_STATE_SSL_HANDSHAKE_FAILED_CODE, ResponseState::RESPONSE_STATE_SSL_HANDSHAKE_FAILED_MSG},
+            {ResponseState::RESPONSE_STATE_INVALID_SSL_CERTIFICATE_CODE, ResponseState::RESPONSE_STATE_INVALID_SSL_CERTIFICATE_MSG}
+        };
+        for (auto &state : states) {
+            if (messages[state.first - MIN_CODE])
+                continue;
+            messages[state.first - MIN_CODE] = state.second;
+            lines[state.first - MIN_CODE] = buildStatusLine(state.first, state.second);
+        }
+    }
+
+    const StatusLines statusLines;
+}
+
+void onyxup::ResponseWriter::setServerAddress(const std::string &ip, int port) {
+    headerPrefix = buildHeaderPrefix(ip, port);
+}
+
+onyxup::ResponseWriter::ResponseWriter(std::string &out, bool headOnly, bool closing) : out(out), headOnly(headOnly),
+                                                                                       closing(closing) {
+    out.clear();
+}
+
+void onyxup::ResponseWriter::status(int code, const char *msg) {
+    static constexpr const char DATE[] = "Date: ";
+    static constexpr const char KEEP_ALIVE[] = "Connection: Keep-Alive\r\n";
+    static constexpr const char CLOSE[] = "Connection: close\r\n";
+    if (statusWritten)
+        throw OnyxupException("Строка статуса ответа уже записана");
+    const std::string *status_line = statusLines.find(code, msg);
+    if (status_line)
+        out.append(*status_line);
+    else
+        out.append(buildStatusLine(code, msg));
+    std::string_view date = HttpDate::now();
+    out.append(headerPrefix);
+    if (closing)
+        out.append(CLOSE, sizeof(CLOSE) - 1);
+    else
+        out.append(KEEP_ALIVE, sizeof(KEEP_ALIVE) - 1);
+    out.append(DATE, sizeof(DATE) - 1);
+    out.append(date.data(), date.size());
+    this->code = code;
+    statusWritten = true;
+}
+
+void onyxup::ResponseWriter::writeStatusIfNeeded() {
+    if (!statusWritten)
+        status(ResponseState::RESPONSE_STATE_OK_CODE, ResponseState::RESPONSE_STATE_OK_MSG);
+}
+
+void onyxup::ResponseWriter::header(std::string_view name, std::string_view value) {
+    if (headerFinished)
+        throw OnyxupException("Заголовок добавляется после начала тела ответа");
+    writeStatusIfNeeded();
+    if (header::equalsIgnoreCase(name, "Content-Length"))
+        contentLengthSet = true;
+    out.append("\r\n", 2);
+    out.append(name.data(), name.size());
+    out.append(": ", 2);
+    out.append(value.data(), value.size());
+}
+
+void onyxup::ResponseWriter::finishHeader() {
+    if (headerFinished)
+        return;
+    writeStatusIfNeeded();
+    out.append("\r\n\r\n", 4);
+    headerFinished = true;
+}
+
+void onyxup::ResponseWriter::beginBody() {
+    if (headerFinished)
+        return;
+    writeStatusIfNeeded();
+    if (!contentLengthSet) {
+        static constexpr const char CONTENT_LENGTH[] = "\r\nContent-Length:";
+        out.append(CONTENT_LENGTH, sizeof(CONTENT_LENGTH) - 1);
+        contentLengthOffset = out.size();
+        out.append(CONTENT_LENGTH_WIDTH, ' ');
+    }
+    finishHeader();
+}
+
+void onyxup::ResponseWriter::write(std::string_view data) {
+    beginBody();
+    bodyLength += data.size();
+    if (!headOnly)
+        out.append(data.data(), data.size());
+}
+
+void onyxup::ResponseWriter::finish() {
+    beginBody();
+    if (contentLengthSet)
+        return;
+    /*
+     * Цифры записываются с конца поля, слева остаются пробелы
+     */
+    char *end = &out[contentLengthOffset + CONTENT_LENGTH_WIDTH];
+    size_t length = bodyLength;
+    do {
+        *--end = '0' + length % 10;
+        length /= 10;
+    } while (length > 0);
+}
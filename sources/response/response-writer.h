@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stddef.h>
+#include <string>
+#include <string_view>
+#include <functional>
+
+#include "../request/request.h"
+#include "../exception/exception.h"
+
+namespace onyxup {
+
+    class ResponseWriter;
+
+    /*
+     * Обработчик маршрута, который записывает ответ сразу в буфер задачи
+     */
+    using ResponseWriterHandler = std::function<void(PtrCRequest request, ResponseWriter & writer)>;
+
+    /*
+     * Последовательная запись ответа в один буфер: строка статуса, заголовки, затем тело частями.
+     * Content-Length проставляется при завершении в поле фиксированной ширины, заполненное
+     * пробелами слева (необязательные пробелы допускаются RFC 7230), поэтому тело не сдвигается.
+     * Для HEAD тело не записывается, но учитывается в Content-Length.
+     * Цепочки подготовки ответа (Range, сжатие) к такому ответу не применяются
+     */
+    class ResponseWriter {
+    private:
+        std::string & out;
+        bool headOnly;
+        bool closing;
+        int code = 0;
+        bool statusWritten = false;
+        bool headerFinished = false;
+        bool contentLengthSet = false;
+        size_t contentLengthOffset = 0;
+        size_t bodyLength = 0;
+
+        void writeStatusIfNeeded();
+
+        void beginBody();
+
+    public:
+
+        /*
+         * Ширина поля значения Content-Length
+         */
+        static constexpr size_t CONTENT_LENGTH_WIDTH = 20;
+
+        /*
+         * Буфер очищается, выделенная под него память используется повторно.
+         * closing - после ответа соединение закрывается, в заголовке Connection: close
+         */
+        explicit ResponseWriter(std::string & out, bool headOnly = false, bool closing = false);
+
+        ResponseWriter(const ResponseWriter &) = delete;
+        ResponseWriter & operator=(const ResponseWriter &) = delete;
+
+        /*
+         * Неизменная часть заголовка (Host, Server, Accept-Ranges), собирается при запуске сервера
+         */
+        static void setServerAddress(const std::string & ip, int port);
+
+        /*
+         * Строка статуса и постоянные заголовки, включая Connection и Date. Если не вызван до первого заголовка
+         * или тела, ответ получает статус 200 OK
+         */
+        void status(int code, const char * msg);
+
+        /*
+         * Заголовок, заданный вручную Content-Length отключает автоматический
+         */
+        void header(std::string_view name, std::string_view value);
+
+        void write(std::string_view data);
+
+        inline void write(const char * data, size_t n) {
+            write(std::string_view(data, n));
+        }
+
+        /*
+         * Завершает заголовок без Content-Length, тело передается отдельно (ResponseBase)
+         */
+        void finishHeader();
+
+        /*
+         * Завершает ответ и проставляет Content-Length
+         */
+        void finish();
+
+        inline int getCode() const {
+            return code;
+        }
+
+        inline size_t getBodyLength() const {
+            return bodyLength;
+        }
+    };
+}
@@ -5,6 +5,7 @@
 
 #include "../request/request.h"
 #include "../response/response-base.h"
+#include "../response/response-writer.h"
 #include "../task/task.h"
 #include "../exception/exception.h"
 
@@ -14,26 +15,52 @@ namespace onyxup {
     private:
         std::string method;
         regex_t pregex;
+        bool regex;
         std::function<ResponseBase(PtrCRequest request) > handler;
+        ResponseWriterHandler writerHandler;
         EnumTaskType type;
-    public:
 
-        Route(const std::string & method, const char * regex, std::function<ResponseBase(PtrCRequest) > & handler, EnumTaskType type) : method(method), handler(handler){
-            this->type = type;
+        void compile(const char * regex) {
             int err;
             err = regcomp(&pregex, regex, REG_EXTENDED);
             if (err != 0)
                 throw OnyxupException("Ошибка создания Route");
         }
+    public:
+
+        Route(const std::string & method, const char * regex, std::function<ResponseBase(PtrCRequest) > & handler, EnumTaskType type) : method(method), regex(true), handler(handler){
+            this->type = type;
+            compile(regex);
+        }
+
+        Route(const std::string & method, const char * regex, ResponseWriterHandler & handler, EnumTaskType type) : method(method), regex(true), writerHandler(handler){
+            this->type = type;
+            compile(regex);
+        }
+
+        /*
+         * Route по шаблону пути (/users/{id:int}), сопоставляется только деревом маршрутов
+         */
+        Route(const std::string & method, std::function<ResponseBase(PtrCRequest) > & handler, EnumTaskType type) : method(method), regex(false), handler(handler){
+            this->type = type;
+        }
+
+        Route(const std::string & method, ResponseWriterHandler & handler, EnumTaskType type) : method(method), regex(false), writerHandler(handler){
+            this->type = type;
+        }
 
         inline std::string getMethod() const {
             return method;
         }
 
-        inline regex_t getPregex() const {
+        inline const regex_t & getPregex() const {
             return pregex;
         }
 
+        inline bool isRegex() const {
+            return regex;
+        }
+
         inline EnumTaskType getTaskType() const {
             return type;
         }
@@ -42,6 +69,25 @@ namespace onyxup {
             return handler;
         }
 
+        /*
+         * Адрес обработчика не меняется, пока в Router не добавляются маршруты
+         */
+        inline const std::function<ResponseBase(PtrCRequest) > & getHandlerRef() const {
+            return handler;
+        }
+
+        inline bool hasWriterHandler() const {
+            return static_cast<bool>(writerHandler);
+        }
+
+        inline const ResponseWriterHandler & getWriterHandlerRef() const {
+            return writerHandler;
+        }
+
+        inline const std::string & getMethodRef() const {
+            return method;
+        }
+
 
 
     };
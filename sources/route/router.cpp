@@ -0,0 +1,292 @@
+#include <string.h>
+#include <algorithm>
+
+#include "router.h"
+
+namespace {
+
+    enum class RegexKind {
+        EXACT,
+        PREFIX,
+        PREFIX_NOT_EMPTY,
+        REGEX
+    };
+
+    /*
+     * Выделяет литеральный префикс регулярного выражения и определяет, сводится ли оно
+     * к точному или префиксному сравнению. Для остальных выражений literal - префикс,
+     * которым гарантированно начинается любой подходящий URI
+     */
+    RegexKind parseRegexLiteral(const char *regex, std::string &literal) {
+        literal.clear();
+        if (regex[0] != '^' || strchr(regex, '|') != nullptr)
+            return RegexKind::REGEX;
+        const char *p = regex + 1;
+        while (*p) {
+            if (*p == '\\') {
+                if (p[1] == '\0' || strchr(".[]()*+?{}|^$\\", p[1]) == nullptr)
+                    break;
+                literal += p[1];
+                p += 2;
+                continue;
+            }
+            if (strchr(".[]()*+?{}|^$", *p) != nullptr)
+                break;
+            literal += *p;
+            p++;
+        }
+        if (strcmp(p, "") == 0 || strcmp(p, ".*") == 0 || strcmp(p, ".*$") == 0)
+            return RegexKind::PREFIX;
+        if (strcmp(p, "$") == 0)
+            return RegexKind::EXACT;
+        if (strcmp(p, ".+") == 0 || strcmp(p, ".+$") == 0)
+            return RegexKind::PREFIX_NOT_EMPTY;
+        /*
+         * Квантификатор относится к последнему символу литерала
+         */
+        if (strchr("*+?{", *p) != nullptr && !literal.empty())
+            literal.pop_back();
+        return RegexKind::REGEX;
+    }
+
+    bool isInteger(std::string_view uri, size_t begin, size_t end) {
+        if (begin < end && uri[begin] == '-')
+            begin++;
+        if (begin == end)
+            return false;
+        for (size_t i = begin; i < end; i++)
+            if (uri[i] < '0' || uri[i] > '9')
+                return false;
+        return true;
+    }
+}
+
+onyxup::Router::Node *onyxup::Router::getTree(const std::string &method) {
+    for (auto &tree : trees)
+        if (tree.first == method)
+            return tree.second.get();
+    trees.emplace_back(method, std::unique_ptr<Node>(new Node));
+    return trees.back().second.get();
+}
+
+const onyxup::Router::Node *onyxup::Router::findTree(std::string_view method) const {
+    for (auto &tree : trees)
+        if (tree.first == method)
+            return tree.second.get();
+    return nullptr;
+}
+
+onyxup::Router::Node *onyxup::Router::insertLiteral(Node *node, const std::string &literal) {
+    size_t i = 0;
+    while (i < literal.size()) {
+        std::unique_ptr<Node> *next = nullptr;
+        for (auto &child : node->children) {
+            if (child->label[0] == literal[i]) {
+                next = &child;
+                break;
+            }
+        }
+        if (next == nullptr) {
+            std::unique_ptr<Node> child(new Node);
+            child->label = literal.substr(i);
+            node->children.push_back(std::move(child));
+            return node->children.back().get();
+        }
+        const std::string &label = (*next)->label;
+        size_t common = 0;
+        while (common < label.size() && i + common < literal.size() && label[common] == literal[i + common])
+            common++;
+        if (common < label.size()) {
+            /*
+             * Делим ребро: общая часть уходит в новый промежуточный узел
+             */
+            std::unique_ptr<Node> middle(new Node);
+            middle->label = label.substr(0, common);
+            (*next)->label = label.substr(common);
+            middle->children.push_back(std::move(*next));
+            *next = std::move(middle);
+        }
+        node = next->get();
+        i += common;
+    }
+    return node;
+}
+
+void onyxup::Router::setRoute(size_t &slot, size_t route) {
+    /*
+     * Повторный маршрут с тем же ключом недостижим - побеждает добавленный раньше
+     */
+    if (slot == NO_ROUTE)
+        slot = route;
+}
+
+void onyxup::Router::addRegexRoute(const std::string &method, const char *regex,
+                                   std::function<ResponseBase(PtrCRequest)> &handler, EnumTaskType type) {
+    routes.push_back(Route(method, regex, handler, type));
+    indexRegexRoute(method, regex, routes.size() - 1);
+}
+
+void onyxup::Router::addRegexRoute(const std::string &method, const char *regex,
+                                   ResponseWriterHandler &handler, EnumTaskType type) {
+    routes.push_back(Route(method, regex, handler, type));
+    indexRegexRoute(method, regex, routes.size() - 1);
+}
+
+void onyxup::Router::indexRegexRoute(const std::string &method, const char *regex, size_t route) {
+    std::string literal;
+    RegexKind kind = parseRegexLiteral(regex, literal);
+    Node *node = insertLiteral(getTree(method), literal);
+    switch (kind) {
+        case RegexKind::EXACT:
+            setRoute(node->exactRoute, route);
+            break;
+        case RegexKind::PREFIX:
+            setRoute(node->prefixRoutes[0], route);
+            break;
+        case RegexKind::PREFIX_NOT_EMPTY:
+            setRoute(node->prefixRoutes[1], route);
+            break;
+        case RegexKind::REGEX:
+            node->regexRoutes.push_back(route);
+            break;
+    }
+}
+
+void onyxup::Router::addPathRoute(const std::string &method, const std::string &path,
+                                  std::function<ResponseBase(PtrCRequest)> &handler, EnumTaskType type) {
+    Node *node = insertPath(method, path);
+    routes.push_back(Route(method, handler, type));
+    setRoute(node->pathRoute, routes.size() - 1);
+}
+
+void onyxup::Router::addPathRoute(const std::string &method, const std::string &path,
+                                  ResponseWriterHandler &handler, EnumTaskType type) {
+    Node *node = insertPath(method, path);
+    routes.push_back(Route(method, handler, type));
+    setRoute(node->pathRoute, routes.size() - 1);
+}
+
+onyxup::Router::Node *onyxup::Router::insertPath(const std::string &method, const std::string &path) {
+    if (path.empty() || path[0] != '/')
+        throw OnyxupException("Ошибка создания Route: шаблон пути должен начинаться с /");
+    Node *node = getTree(method);
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t open = path.find('{', pos);
+        node = insertLiteral(node, path.substr(pos, open == std::string::npos ? std::string::npos : open - pos));
+        if (open == std::string::npos)
+            break;
+        size_t close = path.find('}', open);
+        if (close == std::string::npos || open == 0 || path[open - 1] != '/' ||
+            (close + 1 < path.size() && path[close + 1] != '/'))
+            throw OnyxupException("Ошибка создания Route: параметр должен занимать сегмент пути целиком");
+        std::string param = path.substr(open + 1, close - open - 1);
+        std::string name = param;
+        ParamType param_type = ParamType::STRING;
+        size_t colon = param.find(':');
+        if (colon != std::string::npos) {
+            name = param.substr(0, colon);
+            std::string type_name = param.substr(colon + 1);
+            if (type_name == "int")
+                param_type = ParamType::INT;
+            else if (type_name != "str")
+                throw OnyxupException("Ошибка создания Route: неизвестный тип параметра " + type_name);
+        }
+        if (name.empty())
+            throw OnyxupException("Ошибка создания Route: пустое имя параметра");
+        ParamEdge *edge = nullptr;
+        for (auto &e : node->params) {
+            if (e.name == name && e.type == param_type) {
+                edge = &e;
+                break;
+            }
+        }
+        if (edge == nullptr) {
+            node->params.push_back({name, param_type, std::unique_ptr<Node>(new Node)});
+            edge = &node->params.back();
+        }
+        node = edge->child.get();
+        pos = close + 1;
+    }
+    return node;
+}
+
+void onyxup::Router::lookup(const Node *node, std::string_view uri, size_t pos, size_t pathEnd,
+                            Match &match) const {
+    size_t candidates[4] = {
+            pos == uri.size() ? node->exactRoute : NO_ROUTE,
+            pos == pathEnd ? node->pathRoute : NO_ROUTE,
+            node->prefixRoutes[0],
+            pos < uri.size() ? node->prefixRoutes[1] : NO_ROUTE
+    };
+    for (size_t route : candidates) {
+        if (route < match.route) {
+            match.route = route;
+            match.params = match.stack;
+        }
+    }
+    for (size_t route : node->regexRoutes)
+        match.regexRoutes.push_back(route);
+
+    if (pos < uri.size()) {
+        for (auto &child : node->children) {
+            if (child->label[0] == uri[pos] && uri.compare(pos, child->label.size(), child->label) == 0) {
+                lookup(child.get(), uri, pos + child->label.size(), pathEnd, match);
+                break;
+            }
+        }
+    }
+    if (!node->params.empty() && pos < pathEnd) {
+        size_t end = uri.find('/', pos);
+        if (end == std::string_view::npos || end > pathEnd)
+            end = pathEnd;
+        if (end == pos)
+            return;
+        for (auto &edge : node->params) {
+            if (edge.type == ParamType::INT && !isInteger(uri, pos, end))
+                continue;
+            match.stack.emplace_back(edge.name, uri.substr(pos, end - pos));
+            lookup(edge.child.get(), uri, end, pathEnd, match);
+            match.stack.pop_back();
+        }
+    }
+}
+
+const onyxup::Route *onyxup::Router::match(std::string_view method, std::string_view uri,
+                                           PtrRequest request) const {
+    const Node *tree = findTree(method);
+    if (tree == nullptr)
+        return nullptr;
+    size_t path_end = uri.find('?');
+    if (path_end == std::string_view::npos)
+        path_end = uri.size();
+    thread_local Match match;
+    match.route = NO_ROUTE;
+    match.params.clear();
+    match.stack.clear();
+    match.regexRoutes.clear();
+    lookup(tree, uri, 0, path_end, match);
+
+    /*
+     * Регулярные выражения проверяем по порядку добавления, пока они добавлены раньше найденного маршрута
+     */
+    if (!match.regexRoutes.empty()) {
+        std::sort(match.regexRoutes.begin(), match.regexRoutes.end());
+        for (size_t route : match.regexRoutes) {
+            if (route >= match.route)
+                break;
+            regmatch_t pm;
+            if (regexec(&routes[route].getPregex(), uri.data(), 0, &pm, 0) == 0) {
+                match.route = route;
+                match.params.clear();
+                break;
+            }
+        }
+    }
+    if (match.route == NO_ROUTE)
+        return nullptr;
+    if (request)
+        for (auto &param : match.params)
+            request->addPathParam(param.first, param.second);
+    return &routes[match.route];
+}
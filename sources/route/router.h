@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <limits>
+
+#include "route.h"
+#include "../request/request.h"
+
+namespace onyxup {
+
+    /*
+     * Маршрутизатор: для каждого метода - radix дерево по символам URI.
+     * Регулярные выражения вида ^/literal$, ^/literal, ^/literal.+$, ^/literal.*$ превращаются
+     * в точные и префиксные маршруты дерева, шаблоны путей (/users/{id:int}) - в узлы-параметры.
+     * Остальные регулярные выражения хранятся как листья в узле своего литерального префикса
+     * и проверяются regexec, только если запрос прошел через этот узел.
+     * Из подходящих маршрутов выбирается добавленный раньше всех, как при последовательном переборе
+     */
+    class Router {
+    private:
+        static constexpr size_t NO_ROUTE = std::numeric_limits<size_t>::max();
+
+        enum class ParamType {
+            STRING,
+            INT
+        };
+
+        struct Node;
+
+        struct ParamEdge {
+            std::string name;
+            ParamType type;
+            std::unique_ptr<Node> child;
+        };
+
+        struct Node {
+            std::string label;
+            std::vector<std::unique_ptr<Node>> children;
+            std::vector<ParamEdge> params;
+            /*
+             * exactRoute - URI целиком (со строкой запроса), pathRoute - путь без строки запроса,
+             * prefixRoutes[n] - URI, продолжающийся не меньше чем на n символов
+             */
+            size_t exactRoute = NO_ROUTE;
+            size_t pathRoute = NO_ROUTE;
+            size_t prefixRoutes[2] = {NO_ROUTE, NO_ROUTE};
+            std::vector<size_t> regexRoutes;
+        };
+
+        struct Match {
+            size_t route = NO_ROUTE;
+            std::vector<std::pair<std::string, std::string>> params;
+            std::vector<std::pair<std::string, std::string>> stack;
+            std::vector<size_t> regexRoutes;
+        };
+
+        std::vector<Route> routes;
+        std::vector<std::pair<std::string, std::unique_ptr<Node>>> trees;
+
+        Node * getTree(const std::string & method);
+
+        const Node * findTree(std::string_view method) const;
+
+        static Node * insertLiteral(Node * node, const std::string & literal);
+
+        static void setRoute(size_t & slot, size_t route);
+
+        void indexRegexRoute(const std::string & method, const char * regex, size_t route);
+
+        /*
+         * Создает узлы шаблона пути и возвращает последний
+         */
+        Node * insertPath(const std::string & method, const std::string & path);
+
+        void lookup(const Node * node, std::string_view uri, size_t pos, size_t pathEnd, Match & match) const;
+
+    public:
+
+        Router() {
+            trees.reserve(8);
+        }
+
+        Router(const Router &) = delete;
+
+        /*
+         * Регулярное выражение POSIX ERE, сопоставляется с URI вместе со строкой запроса
+         */
+        void addRegexRoute(const std::string & method, const char * regex,
+                           std::function<ResponseBase(PtrCRequest)> & handler, EnumTaskType type);
+
+        void addRegexRoute(const std::string & method, const char * regex,
+                           ResponseWriterHandler & handler, EnumTaskType type);
+
+        /*
+         * Шаблон пути: литералы и параметры {name}, {name:str}, {name:int} на месте сегмента пути.
+         * Строка запроса при сопоставлении не учитывается
+         */
+        void addPathRoute(const std::string & method, const std::string & path,
+                          std::function<ResponseBase(PtrCRequest)> & handler, EnumTaskType type);
+
+        void addPathRoute(const std::string & method, const std::string & path,
+                          ResponseWriterHandler & handler, EnumTaskType type);
+
+        /*
+         * Возвращает маршрут или nullptr, параметры пути записываются в request.
+         * uri.data() должен завершаться нулевым символом (для regexec)
+         */
+        const Route * match(std::string_view method, std::string_view uri, PtrRequest request) const;
+
+        inline size_t size() const {
+            return routes.size();
+        }
+    };
+}
@@ -0,0 +1,91 @@
+#include "task-scheduler.h"
+
+onyxup::TaskScheduler::TaskScheduler(size_t numberWorkers, size_t capacity) {
+    if (numberWorkers < 1)
+        numberWorkers = 1;
+    size_t worker_capacity = capacity / numberWorkers;
+    if (worker_capacity < 1024)
+        worker_capacity = 1024;
+    for (size_t i = 0; i < numberWorkers; i++)
+        workers.emplace_back(new Worker(worker_capacity));
+}
+
+bool onyxup::TaskScheduler::push(PtrTask task) {
+    size_t n = workers.size();
+    size_t start = counterPush.fetch_add(1, std::memory_order_relaxed) % n;
+    /*
+     * Очередь выбранного воркера заполнена - пробуем следующих
+     */
+    for (size_t i = 0; i < n; i++) {
+        Worker &worker = *workers[(start + i) % n];
+        LockFreeQueue<PtrTask> &queue = task->getType() == EnumTaskType::STATIC_RESOURCES_TASK ?
+                                        worker.staticTasks : worker.localTasks;
+        if (queue.try_push(task)) {
+            events.notify();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool onyxup::TaskScheduler::tryPopType(size_t id, EnumTaskType type, PtrTask &task) {
+    size_t n = workers.size();
+    for (size_t i = 0; i < n; i++) {
+        Worker &worker = *workers[(id + i) % n];
+        LockFreeQueue<PtrTask> &queue = type == EnumTaskType::STATIC_RESOURCES_TASK ?
+                                        worker.staticTasks : worker.localTasks;
+        if (queue.try_pop(task))
+            return true;
+    }
+    return false;
+}
+
+bool onyxup::TaskScheduler::tryPop(size_t id, PtrTask &task) {
+    /*
+     * Сначала своя очередь, затем очереди соседей начиная со следующего
+     */
+    if (++workers[id]->counterPop % LOCAL_PRIORITY_PERIOD == 0) {
+        if (tryPopType(id, EnumTaskType::LOCAL_TASK, task))
+            return true;
+        return tryPopType(id, EnumTaskType::STATIC_RESOURCES_TASK, task);
+    }
+    if (tryPopType(id, EnumTaskType::STATIC_RESOURCES_TASK, task))
+        return true;
+    return tryPopType(id, EnumTaskType::LOCAL_TASK, task);
+}
+
+onyxup::PtrTask onyxup::TaskScheduler::pop(size_t id) {
+    PtrTask task = nullptr;
+    for (;;) {
+        for (int i = 0; i < SPIN_COUNT; i++) {
+            if (tryPop(id, task))
+                return task;
+            LockFreeQueue<PtrTask>::pause();
+        }
+        uint32_t key = events.prepareWait();
+        if (tryPop(id, task)) {
+            events.cancelWait();
+            return task;
+        }
+        events.wait(key);
+        if (tryPop(id, task)) {
+            /*
+             * Задачи еще есть - будим следующего спящего воркера
+             */
+            if (size() > 0)
+                events.notify();
+            return task;
+        }
+    }
+}
+
+size_t onyxup::TaskScheduler::size(EnumTaskType type) const {
+    size_t total = 0;
+    for (auto &worker : workers)
+        total += type == EnumTaskType::STATIC_RESOURCES_TASK ? worker->staticTasks.size() : worker->localTasks.size();
+    return total;
+}
+
+size_t onyxup::TaskScheduler::size() const {
+    return size(EnumTaskType::STATIC_RESOURCES_TASK) + size(EnumTaskType::LOCAL_TASK);
+}
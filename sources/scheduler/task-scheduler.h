@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+#include "../task/task.h"
+#include "../queue/lock-free-queue.h"
+#include "../queue/event-count.h"
+
+namespace onyxup {
+
+    /*
+     * Планировщик задач воркеров. У каждого воркера свои очереди статических и локальных задач,
+     * реакторы раскладывают задачи по воркерам по кругу, воркер без работы забирает задачи
+     * из очередей соседей. Статические задачи (короткие) выбираются первыми, каждая
+     * LOCAL_PRIORITY_PERIOD-я выборка начинается с локальных, чтобы поток статики их не вытеснял
+     */
+    class TaskScheduler {
+    private:
+        static constexpr int SPIN_COUNT = 64;
+        static constexpr size_t LOCAL_PRIORITY_PERIOD = 8;
+
+        struct Worker {
+            LockFreeQueue<PtrTask> staticTasks;
+            LockFreeQueue<PtrTask> localTasks;
+            size_t counterPop = 0;
+
+            explicit Worker(size_t capacity) : staticTasks(capacity), localTasks(capacity) {}
+        };
+
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::atomic<size_t> counterPush{0};
+        EventCount events;
+
+        bool tryPopType(size_t id, EnumTaskType type, PtrTask & task);
+
+        bool tryPop(size_t id, PtrTask & task);
+
+    public:
+
+        /*
+         * capacity - общая емкость очередей задач одного типа, делится между воркерами
+         */
+        TaskScheduler(size_t numberWorkers, size_t capacity = 65536);
+
+        TaskScheduler(const TaskScheduler &) = delete;
+
+        /*
+         * Вызывается реакторами. Возвращает false, если очереди задач этого типа заполнены
+         */
+        bool push(PtrTask task);
+
+        /*
+         * Вызывается воркером id, ждет задачу
+         */
+        PtrTask pop(size_t id);
+
+        /*
+         * Приблизительное количество задач в очередях
+         */
+        size_t size(EnumTaskType type) const;
+
+        size_t size() const;
+
+        inline size_t getNumberWorkers() const {
+            return workers.size();
+        }
+    };
+}
@@ -0,0 +1,695 @@
+#include "reactor.h"
+#include "server.h"
+#include "../response/http-date.h"
+
+static int setNonBlockingModeSocket(int fd) {
+    int flags;
+    if (-1 == (flags = fcntl(fd, F_GETFL, 0)))
+        flags = 0;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+onyxup::Reactor::Reactor(HttpServer *server, size_t id, int port, size_t maxConnection) : server(server), id(id),
+                                                                                           maxConnection(maxConnection),
+                                                                                           bufferPool(server->maxInputBufferLength),
+                                                                                           timerWheel(maxConnection),
+                                                                                           taskPool(maxConnection) {
+    struct sockaddr_in server_addr;
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOGE << "Не возможно создать серверный сокет";
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+    int enable = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) < 0) {
+        close(fd);
+        LOGE << "Не возможно создать серверный сокет. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+    /*
+     * Каждый реактор слушает свой сокет на одном и том же порту,
+     * ядро распределяет входящие соединения между ними
+     */
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(int)) < 0) {
+        close(fd);
+        LOGE << "Не возможно установить SO_REUSEPORT для серверного сокета. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+    if (setNonBlockingModeSocket(fd) == -1) {
+        close(fd);
+        LOGE << "Не возможно создать серверный сокет. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_addr.s_addr = inet_addr("0.0.0.0");
+    server_addr.sin_port = htons(port);
+
+    if (bind(fd, (struct sockaddr *) &server_addr, sizeof(server_addr)) < 0) {
+        close(fd);
+        LOGE << "Не возможно выполнить операцию bind. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+
+    if (listen(fd, SOMAXCONN) < 0) {
+        close(fd);
+        LOGE << "Не возможно выполнить операцию listen. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+
+    epollFd = epoll_create1(0);
+    if (epollFd == -1) {
+        close(fd);
+        LOGE << "Не возможно создать epoll. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+
+    struct epoll_event event;
+    event.data.fd = fd;
+    event.events = EPOLLIN;
+
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+
+    /*
+     * Через eventfd воркеры сообщают реактору о выполненных задачах
+     */
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd == -1) {
+        close(fd);
+        close(epollFd);
+        LOGE << "Не возможно создать eventfd. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+    event.data.fd = eventFd;
+    event.events = EPOLLIN;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, eventFd, &event) == -1) {
+        close(fd);
+        close(epollFd);
+        close(eventFd);
+        LOGE << "Не возможно добавить eventfd в epoll. Ошибка " << errno;
+        throw OnyxupException("Не возможно создать серверный сокет");
+    }
+
+    buffers = new PtrBuffer[maxConnection];
+    requests = new PtrRequest[maxConnection];
+    connectionIds.resize(maxConnection, 0);
+    responseQueues.resize(maxConnection);
+    epollEvents.resize(maxConnection, 0);
+    for (size_t i = 0; i < maxConnection; i++) {
+        buffers[i] = nullptr;
+        requests[i] = nullptr;
+    }
+}
+
+onyxup::Reactor::~Reactor() {
+    for (size_t i = 0; i < maxConnection; i++)
+        if (requests[i])
+            closeAllSocketsAndClearData(i);
+    shutdown(fd, SHUT_RD);
+    close(fd);
+    close(epollFd);
+    close(eventFd);
+    delete[] buffers;
+    delete[] requests;
+}
+
+bool onyxup::Reactor::updateEpollEvents(int fd) noexcept {
+    uint32_t events = EPOLLERR | EPOLLHUP | EPOLLRDHUP;
+    if (!requests[fd]->isClosingConnect() && responseQueues[fd].size() < MAX_PIPELINE_DEPTH &&
+        buffers[fd]->getBytesToSend() < server->maxOutputBufferLength)
+        events |= EPOLLIN;
+    if (buffers[fd]->getBytesToSend() > 0)
+        events |= EPOLLOUT;
+    if (events == epollEvents[fd])
+        return true;
+    struct epoll_event event;
+    event.data.fd = fd;
+    event.events = events;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == -1) {
+        LOGE << "Не возможно модифицировать файловый дескриптор в epoll. Ошибка " << errno;
+        closeAllSocketsAndClearData(fd);
+        return false;
+    }
+    epollEvents[fd] = events;
+    return true;
+}
+
+void onyxup::Reactor::run() noexcept {
+    sockaddr_in peer_addr;
+    int address_length = sizeof(peer_addr);
+    struct epoll_event events[maxEventsEpoll];
+    struct epoll_event event;
+
+    for (;;) {
+        if (HttpServer::isStatisticsEnable)
+            server->statisticsService->setCurrentNumberTasks(server->scheduler->size());
+
+        timerWheel.expire(std::chrono::steady_clock::now(), expiredTimers);
+        for (int conn_fd : expiredTimers)
+            processExpiredTimer(conn_fd);
+        expiredTimers.clear();
+
+        int fds = epoll_wait(epollFd, events, maxEventsEpoll, 100);
+        /*
+         * Выполненные задачи разбираются после всех событий пачки: их обработка может закрыть
+         * любое соединение, и оставшиеся события пачки относились бы к уже закрытому
+         * или принятому заново под тем же дескриптором соединению
+         */
+        bool performed = false;
+        for (int i = 0; i < fds; i++) {
+            if (events[i].data.fd == eventFd) {
+                eventfd_t value;
+                eventfd_read(eventFd, &value);
+                eventFdNotified.store(false);
+                performed = true;
+                continue;
+            }
+            if ((events[i].events & EPOLLERR) || (events[i].events & EPOLLHUP) || (events[i].events & EPOLLRDHUP)) {
+                closeAllSocketsAndClearData(events[i].data.fd);
+                continue;
+            }
+            if (events[i].data.fd == fd) {
+                int conn_sock = accept(fd, (struct sockaddr *) &peer_addr, (socklen_t *) &address_length);
+                if (conn_sock > (int) maxConnection - 1) {
+                    closeSocket(conn_sock);
+                    LOGE << "Превышено максимальное количество соединений на сервере";
+                    continue;
+                }
+                if (conn_sock == -1) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                        LOGE << "Не возможно принять соединение на сервере. Ошибка " << errno;
+                    }
+                    continue;
+                }
+                if (setNonBlockingModeSocket(conn_sock) == -1) {
+                    closeSocket(conn_sock);
+                    LOGE << "Не возможно перевести сокет в неблокирующий режим. Ошибка " << errno;
+                    continue;
+                }
+                event.events = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
+                event.data.fd = conn_sock;
+                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, conn_sock, &event) == -1) {
+                    closeSocket(conn_sock);
+                    LOGE << "Не возможно добавить файловый дескриптор в epoll. Ошибка " << errno;
+                    continue;
+                }
+                epollEvents[conn_sock] = event.events;
+
+                if (HttpServer::isStatisticsEnable)
+                    server->statisticsService->addTotalNumberConnectionsAccepted();
+
+                connectionIds[conn_sock] = ++counterConnections;
+
+                /*
+                 * Подготавливаем входной и выходной буфер, выделяем память
+                 */
+                buffers[conn_sock] = bufferPool.getBuffer();
+                if (buffers[conn_sock] == nullptr) {
+                    LOGE << "Ошибка выделение памяти";
+                    closeSocket(conn_sock);
+                    continue;
+                }
+
+                /*
+                 * Подготавливаем req
+                 */
+
+                requests[conn_sock] = req::requestFactory();
+                if (requests[conn_sock] == nullptr) {
+                    closeSocket(conn_sock);
+                    bufferPool.releaseBuffer(buffers[conn_sock]);
+                    buffers[conn_sock] = nullptr;
+                    continue;
+                }
+                requests[conn_sock]->setFD(conn_sock);
+                requests[conn_sock]->setMaxOutputLengthBuffer(server->maxOutputBufferLength);
+                armIdleTimer(conn_sock);
+            } else {
+                if (requests[events[i].data.fd] == nullptr)
+                    continue;
+                if (events[i].events & EPOLLIN) {
+                    int conn_fd = events[i].data.fd;
+                    bool idle = responseQueues[conn_fd].empty() && buffers[conn_fd]->getPosInputBuffer() == 0 &&
+                                buffers[conn_fd]->getBytesToSend() == 0;
+                    ssize_t res = receiveToInputBuffer(conn_fd);
+                    if (res == -1) {
+                        closeAllSocketsAndClearData(conn_fd);
+                        continue;
+                    }
+                    /*
+                     * Начало нового запроса - отсчитываем время его выполнения
+                     */
+                    if (idle && res > 0)
+                        armRequestTimer(conn_fd);
+                    if (!processInputBuffer(conn_fd))
+                        continue;
+                    PtrBuffer buffer = buffers[conn_fd];
+                    PtrRequest request = requests[conn_fd];
+                    if (!request->isClosingConnect() && responseQueues[conn_fd].size() < MAX_PIPELINE_DEPTH &&
+                        buffer->getPosInputBuffer() >= buffer->getMaxInputBufferLength()) {
+                        /*
+                         * Входной буфер заполнен, а запрос в нем так и не получен полностью
+                         */
+                        LOGD << "Превышен размер входного буфера";
+                        request->setClosingConnect(true);
+                        if (!enqueueReadyResponse(conn_fd, nullptr, CannedResponse::PAYLOAD_TOO_LARGE))
+                            continue;
+                    }
+                    if (!flushResponseQueue(conn_fd) || !updateEpollEvents(conn_fd))
+                        continue;
+                }
+                if (events[i].events & EPOLLOUT && buffers[events[i].data.fd] &&
+                    buffers[events[i].data.fd]->getBytesToSend() > 0) {
+                    int conn_fd = events[i].data.fd;
+                    if (!flushResponseQueue(conn_fd))
+                        continue;
+                    /*
+                     * Отправленные ответы освободили место в очереди - разбираем запросы,
+                     * оставшиеся во входном буфере
+                     */
+                    if (buffers[conn_fd]->getPosInputBuffer() > 0 &&
+                        (!processInputBuffer(conn_fd) || !flushResponseQueue(conn_fd)))
+                        continue;
+                    updateEpollEvents(conn_fd);
+                }
+            }
+        }
+        if (performed)
+            processPerformedTasks();
+    }
+}
+
+bool onyxup::Reactor::processInputBuffer(int fd) noexcept {
+    PtrBuffer buffer = buffers[fd];
+    PtrRequest request = requests[fd];
+    size_t offset = 0;
+    while (!request->isClosingConnect() && offset < buffer->getPosInputBuffer()) {
+        /*
+         * Очередь заполнена - отправляем готовые ответы, чтобы освободить в ней место
+         */
+        if (responseQueues[fd].size() >= MAX_PIPELINE_DEPTH) {
+            if (!flushResponseQueue(fd))
+                return false;
+            if (responseQueues[fd].size() >= MAX_PIPELINE_DEPTH)
+                break;
+        }
+        const char *data = buffer->getInputBuffer() + offset;
+        size_t length = buffer->getPosInputBuffer() - offset;
+        if (!request->isHeaderAccept()) {
+            /*
+             * Передаем длину буфера на предыдущем разборе, чтобы парсер проверял
+             * только новые данные, пока заголовок не получен полностью
+             */
+            int version;
+            int parse_http_result = request->parseHeader(data, length, request->getLastLengthInputBuffer(), version);
+            if (parse_http_result == -2) {
+                request->setLastLengthInputBuffer(length);
+                break;
+            } else if (parse_http_result == -1) {
+                LOGE << "Ошибка разбора HTTP запроса";
+                closeAllSocketsAndClearData(fd);
+                return false;
+            } else if (parse_http_result == -3) {
+                LOGE << "Не удалось выделить память под заголовок HTTP запроса";
+                request->setClosingConnect(true);
+                if (!enqueueReadyResponse(fd, nullptr, CannedResponse::SERVICE_UNAVAILABLE))
+                    return false;
+                break;
+            }
+
+            request->setHeaderAccept(true);
+            /*
+             * Получаем параметры строки запроса
+             */
+            utils::parseParamsRequest(request, request->getFullURIRef().size());
+
+            /*
+             * HTTP/1.1 по умолчанию держит соединение открытым, HTTP/1.0 - только с Connection: keep-alive
+             */
+            request->setKeepAlive(version == 1);
+            std::optional<std::string_view> connection = request->findHeader(HttpHeader::CONNECTION);
+            if (connection) {
+                if (header::equalsIgnoreCase(*connection, "close"))
+                    request->setKeepAlive(false);
+                else if (header::equalsIgnoreCase(*connection, "keep-alive"))
+                    request->setKeepAlive(true);
+            }
+
+            /*
+             * Определяем должен ли запрос содержать тело. Transfer-Encoding имеет приоритет
+             * над Content-Length, из кодировок поддерживается только chunked (последней в списке)
+             */
+            std::optional<std::string_view> transfer_encoding = request->findHeader(HttpHeader::TRANSFER_ENCODING);
+            if (transfer_encoding) {
+                size_t end = transfer_encoding->find_last_not_of(" \t");
+                size_t len = sizeof("chunked") - 1;
+                if (end == std::string_view::npos || end + 1 < len ||
+                    !header::equalsIgnoreCase(transfer_encoding->substr(end + 1 - len, len), "chunked")) {
+                    LOGE << "Не поддерживаемый Transfer-Encoding " << *transfer_encoding;
+                    closeAllSocketsAndClearData(fd);
+                    return false;
+                }
+                request->setChunked(true);
+            } else {
+                std::optional<std::string_view> content_length = request->findHeader(HttpHeader::CONTENT_LENGTH);
+                if (content_length) {
+                    int len = atoi(content_length->data());
+                    if (len > 0) {
+                        request->setContentLength(len);
+                        request->setBodyExists(true);
+                    }
+                }
+            }
+
+            /*
+             * Тело не поместится во входной буфер - отвечаем 413 не дожидаясь его получения
+             */
+            if (request->getHeaderLength() + request->getContentLength() > buffer->getMaxInputBufferLength()) {
+                LOGD << "Превышен размер входного буфера";
+                request->setClosingConnect(true);
+                if (!enqueueReadyResponse(fd, nullptr, CannedResponse::PAYLOAD_TOO_LARGE))
+                    return false;
+                break;
+            }
+        }
+
+        /*
+         * Декодируем chunked тело на месте: во входном буфере за заголовком лежит уже декодированная
+         * часть тела, сразу за ней - еще не декодированные данные. Декодер дописывает тело и
+         * удаляет служебные байты, так что дальше запрос разбирается как с Content-Length
+         */
+        if (request->isChunked() && !request->isBodyExists()) {
+            size_t decoded = request->getHeaderLength() + request->getContentLength();
+            size_t raw_length = length - decoded;
+            size_t size = raw_length;
+            ssize_t ret = phr_decode_chunked(request->getChunkedDecoder(), buffer->getInputBuffer() + offset + decoded,
+                                             &size);
+            if (ret == -1) {
+                LOGE << "Ошибка декодирования chunked тела HTTP запроса";
+                closeAllSocketsAndClearData(fd);
+                return false;
+            }
+            /*
+             * Данные следующего запроса (tail) декодер переносит сразу за телом
+             */
+            size_t tail = ret >= 0 ? (size_t) ret : 0;
+            buffer->eraseInputBuffer(offset + decoded + size + tail, raw_length - size - tail);
+            request->setContentLength(request->getContentLength() + size);
+            length = buffer->getPosInputBuffer() - offset;
+            if (ret == -2)
+                break;
+            request->setBodyExists(request->getContentLength() > 0);
+        }
+
+        /*
+         * Получаем тело запроса, заголовок повторно не разбирается
+         */
+        if (request->isBodyExists()) {
+            if (length < request->getHeaderLength() + request->getContentLength())
+                break;
+            request->setBodyAccept(true);
+            if (!request->setBody(data + request->getHeaderLength(), request->getContentLength())) {
+                LOGE << "Не удалось выделить память под тело HTTP запроса";
+                request->setClosingConnect(true);
+                if (!enqueueReadyResponse(fd, nullptr, CannedResponse::SERVICE_UNAVAILABLE))
+                    return false;
+                break;
+            }
+        }
+
+        /*
+         * Запрос получен полностью, следующий запрос (если есть) начинается сразу за ним
+         */
+        offset += request->getHeaderLength() + request->getContentLength();
+        if (!request->isKeepAlive())
+            request->setClosingConnect(true);
+        if (!dispatchRequest(fd))
+            return false;
+        request->clear();
+    }
+    buffer->consumeInputBuffer(offset);
+    return true;
+}
+
+onyxup::PtrTask onyxup::Reactor::acquireTask(int fd) noexcept {
+    PtrTask task = taskPool.acquire();
+    if (task == nullptr) {
+        LOGE << "Ошибка выделение памяти";
+        closeAllSocketsAndClearData(fd);
+        return nullptr;
+    }
+    req::moveRequest(task->getRequest(), requests[fd]);
+    task->setFD(fd);
+    task->setConnectionId(connectionIds[fd]);
+    task->setReactor(this);
+    return task;
+}
+
+bool onyxup::Reactor::dispatchRequest(int fd) noexcept {
+    PtrTask task = acquireTask(fd);
+    if (task == nullptr)
+        return false;
+    server->statisticsService->addTotalNumberClientRequests();
+    if (!server->dispatcher(task))
+        return enqueueReadyResponse(fd, task, CannedResponse::NOT_FOUND);
+    /*
+     * В зависимости от типа задачи направляем в соответствующий поток
+     */
+    if (task->getType() == EnumTaskType::LOCAL_TASK) {
+        if (server->scheduler->size(EnumTaskType::LOCAL_TASK) > (size_t) HttpServer::limitLocalTasks)
+            return enqueueReadyResponse(fd, task, CannedResponse::SERVICE_UNAVAILABLE);
+    } else if (task->getType() != EnumTaskType::STATIC_RESOURCES_TASK) {
+        LOGE << "Не известный тип задачи";
+        taskPool.release(task);
+        closeAllSocketsAndClearData(fd);
+        return false;
+    }
+    /*
+     * Задача попадает в очередь ответов после постановки воркерам: выполненные задачи
+     * разбираются этим же потоком реактора, так что порядок не нарушается
+     */
+    if (!server->addTask(task))
+        return enqueueReadyResponse(fd, task, CannedResponse::SERVICE_UNAVAILABLE);
+    responseQueues[fd].push(task);
+    return true;
+}
+
+bool onyxup::Reactor::enqueueReadyResponse(int fd, PtrTask task, CannedResponse response) noexcept {
+    if (task == nullptr) {
+        task = acquireTask(fd);
+        if (task == nullptr)
+            return false;
+    }
+    const CannedResponses::Entry &entry = cannedResponses.get(response, HttpDate::now(),
+                                                                task->getRequest()->isClosingConnect());
+    task->setCode(entry.code);
+    task->setSharedResponse(entry.header, entry.body);
+    task->setPerformed(true);
+    responseQueues[fd].push(task);
+    return true;
+}
+
+bool onyxup::Reactor::flushResponseQueue(int fd) noexcept {
+    ResponseQueue &queue = responseQueues[fd];
+    PtrBuffer buffer = buffers[fd];
+    struct iovec iov[MAX_PIPELINE_DEPTH * 3];
+    bool sent = false;
+    for (;;) {
+        size_t total = 0;
+        ssize_t res;
+        int file_fd;
+        off_t file_offset;
+        if (queue.fillFile(file_fd, file_offset, total)) {
+            /*
+             * Тело из файла передается ядром напрямую из page cache в сокет
+             */
+            buffer->setBytesToSend(total);
+            res = sendfile(fd, file_fd, &file_offset, total);
+            if (res == 0) {
+                LOGE << "Файл статического ресурса стал короче заявленной длины, соединение закрывается";
+                closeAllSocketsAndClearData(fd);
+                return false;
+            }
+        } else {
+            size_t count = queue.fill(iov, MAX_PIPELINE_DEPTH * 3);
+            for (size_t i = 0; i < count; i++)
+                total += iov[i].iov_len;
+            buffer->setBytesToSend(total);
+            if (count == 0)
+                break;
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = count;
+            res = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        }
+        if (res == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            closeAllSocketsAndClearData(fd);
+            return false;
+        }
+        sent = true;
+        queue.consume(res, [this](PtrTask task) {
+            LOGI << task->getRequest()->getMethodRef() << " " << task->getRequest()->getFullURIRef() << " "
+                 << task->getCode();
+            taskPool.release(task);
+        });
+        buffer->setBytesToSend(total - res);
+    }
+    if (!sent || buffer->getBytesToSend() > 0)
+        return true;
+    /*
+     * Все готовые ответы приняты сокетом
+     */
+    if (queue.empty() && requests[fd]->isClosingConnect()) {
+        closeAllSocketsAndClearData(fd);
+        return false;
+    }
+    /*
+     * Соединение простаивает - выросший буфер возвращаем в пул
+     */
+    if (queue.empty() && buffer->getPosInputBuffer() == 0) {
+        buffer->clear();
+        armIdleTimer(fd);
+    } else
+        armRequestTimer(fd);
+    return true;
+}
+
+void onyxup::Reactor::dropResponseQueue(int fd, bool keepSending) noexcept {
+    ResponseQueue &queue = responseQueues[fd];
+    /*
+     * Начатый ответ дописывается, иначе поток ответов клиенту будет испорчен
+     */
+    PtrTask sending = nullptr;
+    size_t sent = queue.getSent();
+    if (keepSending && sent > 0)
+        sending = queue.pop();
+    while (!queue.empty()) {
+        PtrTask task = queue.pop();
+        if (task->isPerformed())
+            taskPool.release(task);
+    }
+    if (sending) {
+        queue.push(sending);
+        queue.consume(sent, [](PtrTask) {});
+    }
+    connectionIds[fd] = ++counterConnections;
+}
+
+ssize_t onyxup::Reactor::receiveToInputBuffer(int fd) noexcept {
+    PtrBuffer buffer = buffers[fd];
+    char spill[64 * 1024];
+    ssize_t total = 0;
+    for (;;) {
+        /*
+         * Читаем в свободную часть буфера, остаток - во временный буфер на стеке,
+         * откуда он дописывается с увеличением входного буфера. Больше, чем поместится
+         * во входной буфер, из сокета не забираем - остаток дочитается после разбора запросов
+         */
+        size_t free = buffer->reserveInputBuffer(BufferPool::INITIAL_BUFFER_LENGTH);
+        size_t room = buffer->getMaxInputBufferLength() - buffer->getPosInputBuffer() - free;
+        size_t spill_len = room < sizeof(spill) ? room : sizeof(spill);
+        if (free == 0 && spill_len == 0)
+            return total;
+        struct iovec iov[2];
+        iov[0].iov_base = buffer->getInputBufferTail();
+        iov[0].iov_len = free;
+        iov[1].iov_base = spill;
+        iov[1].iov_len = spill_len;
+        ssize_t res = readv(fd, iov, 2);
+        if (res == -1) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return total;
+            LOGE << "Не возможно прочитать данные из сокета. Ошибка " << errno;
+            return -1;
+        }
+        if (res == 0)
+            return -1;
+        if ((size_t) res <= free)
+            buffer->commitInputBuffer(res);
+        else {
+            buffer->commitInputBuffer(free);
+            if (!buffer->addDataToInputBuffer(spill, res - free))
+                return -1;
+        }
+        total += res;
+        /*
+         * Прочитано меньше, чем было места - сокет пуст, лишний вызов readv не нужен
+         */
+        if ((size_t) res < free + spill_len)
+            return total;
+    }
+}
+
+void onyxup::Reactor::processPerformedTasks() noexcept {
+    PtrTask task = nullptr;
+    while (performedTasksQueue.try_pop(task)) {
+        /*
+         * Проверяем что данный сокет еще жив
+        */
+        int conn_fd = task->getFD();
+        if (task->getConnectionId() != connectionIds[conn_fd] || requests[conn_fd] == nullptr) {
+            taskPool.release(task);
+            continue;
+        }
+        task->setPerformed(true);
+        if (!flushResponseQueue(conn_fd))
+            continue;
+        /*
+         * В очереди освободилось место - разбираем запросы, оставшиеся во входном буфере
+         */
+        if (buffers[conn_fd]->getPosInputBuffer() > 0 &&
+            (!processInputBuffer(conn_fd) || !flushResponseQueue(conn_fd)))
+            continue;
+        updateEpollEvents(conn_fd);
+    }
+}
+
+void onyxup::Reactor::processExpiredTimer(int fd) noexcept {
+    PtrRequest request = requests[fd];
+    if (request == nullptr)
+        return;
+    if (responseQueues[fd].empty() && (request->getFullURIRef().empty() || request->isClosingConnect())) {
+        closeAllSocketsAndClearData(fd);
+        return;
+    }
+    /*
+     * Ответы, которые еще не готовы, не ждем - отправляем 408 и закрываем соединение
+     */
+    dropResponseQueue(fd, true);
+    request->setClosingConnect(true);
+    if (!enqueueReadyResponse(fd, nullptr, CannedResponse::REQUEST_TIMEOUT) || !flushResponseQueue(fd) || !updateEpollEvents(fd))
+        return;
+    armRequestTimer(fd);
+}
+
+void onyxup::Reactor::armIdleTimer(int fd) noexcept {
+    timerWheel.arm(fd, std::chrono::steady_clock::now() + std::chrono::seconds(HttpServer::keepAliveTimeoutSeconds));
+}
+
+void onyxup::Reactor::armRequestTimer(int fd) noexcept {
+    timerWheel.arm(fd, std::chrono::steady_clock::now() + std::chrono::seconds(HttpServer::timeLimitRequestSeconds));
+}
+
+void onyxup::Reactor::closeAllSocketsAndClearData(int fd) {
+    /*
+     * Соединение уже закрыто - дескриптор мог достаться другому сокету
+     */
+    if (requests[fd] == nullptr)
+        return;
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+    dropResponseQueue(fd);
+    timerWheel.cancel(fd);
+    bufferPool.releaseBuffer(buffers[fd]);
+    delete requests[fd];
+    epollEvents[fd] = 0;
+    buffers[fd] = nullptr;
+    requests[fd] = nullptr;
+    server->statisticsService->addTotalNumberConnectionsProcessed();
+}
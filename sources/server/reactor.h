@@ -0,0 +1,186 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+#include "../buffer/buffer.h"
+#include "../request/request.h"
+#include "../task/task.h"
+#include "../task/task-pool.h"
+#include "../queue/lock-free-queue.h"
+#include "../queue/response-queue.h"
+#include "../timer/timer-wheel.h"
+#include "../response/canned-responses.h"
+
+namespace onyxup {
+
+    class HttpServer;
+
+    class Reactor;
+
+    using PtrReactor = Reactor *;
+
+    /*
+     * Реактор - цикл обработки событий epoll со своим слушающим сокетом (SO_REUSEPORT),
+     * своей таблицей соединений и очередью выполненных задач.
+     * Ядро распределяет входящие соединения между слушающими сокетами реакторов.
+     */
+    class Reactor {
+    private:
+        HttpServer * server;
+        size_t id;
+        int fd;
+        int epollFd;
+        int eventFd;
+        std::atomic<bool> eventFdNotified{false};
+        size_t maxConnection;
+        size_t maxEventsEpoll = 100;
+        BufferPool bufferPool;
+        PtrBuffer * buffers;
+        PtrRequest * requests;
+        /*
+         * Таймеры соединений: пока соединение простаивает - таймаут keep-alive,
+         * пока запрос принимается или обрабатывается - таймаут выполнения запроса
+         */
+        TimerWheel timerWheel;
+        std::vector<int> expiredTimers;
+
+        /*
+         * Задачи вместе с их запросами берутся из пула и возвращаются в него после отправки ответа
+         */
+        TaskPool taskPool;
+
+        CannedResponses cannedResponses;
+
+        /*
+         * Идентификатор соединения меняется при закрытии сокета, по нему задачи,
+         * вернувшиеся от воркеров, отличают свое соединение от нового с тем же fd
+         */
+        std::vector<unsigned long long> connectionIds;
+        unsigned long long counterConnections = 0;
+
+        /*
+         * Очереди ответов соединений и текущие маски событий epoll
+         */
+        std::vector<ResponseQueue> responseQueues;
+        std::vector<uint32_t> epollEvents;
+
+        LockFreeQueue<PtrTask> performedTasksQueue;
+
+        void closeAllSocketsAndClearData(int fd);
+
+        inline void closeSocket(int fd) {
+            shutdown(fd, SHUT_RDWR);
+            close(fd);
+        }
+
+        void processPerformedTasks() noexcept;
+
+        /*
+         * Простаивающее соединение закрывается, на незавершенный запрос отправляется 408
+         */
+        void processExpiredTimer(int fd) noexcept;
+
+        void armIdleTimer(int fd) noexcept;
+
+        void armRequestTimer(int fd) noexcept;
+
+        /*
+         * Разбирает все полностью полученные запросы из входного буфера и отправляет их на обработку,
+         * пока не заполнена очередь ответов соединения. Возвращает false, если соединение закрыто
+         */
+        bool processInputBuffer(int fd) noexcept;
+
+        bool dispatchRequest(int fd) noexcept;
+
+        /*
+         * Берет задачу из пула и передает ей текущий запрос соединения
+         */
+        PtrTask acquireTask(int fd) noexcept;
+
+        /*
+         * Ставит в очередь ответов соединения заранее сформированный ответ реактора (404, 408, 413, 503).
+         * Если task == nullptr, задача берется из пула с текущим запросом соединения.
+         * Ответ отправляется следующим вызовом flushResponseQueue
+         */
+        bool enqueueReadyResponse(int fd, PtrTask task, CannedResponse response) noexcept;
+
+        /*
+         * Отправляет готовые ответы из начала очереди соединения через sendmsg: заголовок и тело
+         * каждого ответа передаются отдельными элементами iovec прямо из задач, пока сокет
+         * принимает данные (до EAGAIN). Отправленные задачи возвращаются в пул.
+         * Возвращает false, если соединение закрыто
+         */
+        bool flushResponseQueue(int fd) noexcept;
+
+        /*
+         * Удаляет ответы из очереди соединения. Задачи, которые еще выполняются воркерами,
+         * будут удалены по возвращении (идентификатор соединения меняется).
+         * При keepSending частично отправленный ответ остается в очереди
+         */
+        void dropResponseQueue(int fd, bool keepSending = false) noexcept;
+
+        /*
+         * Выставляет маску событий epoll по состоянию соединения: EPOLLIN, пока принимаются запросы,
+         * EPOLLOUT, пока есть неотправленные данные. Возвращает false, если соединение закрыто.
+         * Пока неотправленных данных больше HttpServer::maxOutputBufferLength, запросы не читаются
+         */
+        bool updateEpollEvents(int fd) noexcept;
+
+        /*
+         * Читает данные из сокета сразу во входной буфер соединения, пока сокет не опустеет
+         * или буфер не заполнится до максимального размера. Возвращает количество прочитанных байт
+         * (0 - данных нет или буфер заполнен), -1 - соединение закрыто клиентом, ошибка чтения
+         * или не удалось выделить память. Заполненный буфер без полного запроса проверяет
+         * вызывающий код (ответ 413)
+         */
+        ssize_t receiveToInputBuffer(int fd) noexcept;
+
+    public:
+
+        /*
+         * Максимальное количество запросов соединения, ожидающих ответа.
+         * При достижении сокет перестает читаться до отправки ответов
+         */
+        static constexpr size_t MAX_PIPELINE_DEPTH = 32;
+
+        Reactor(HttpServer * server, size_t id, int port, size_t maxConnection);
+
+        Reactor(const Reactor &) = delete;
+        ~Reactor();
+
+        void run() noexcept;
+
+        /*
+         * Вызывается из потоков воркеров. Будим реактор через eventfd,
+         * если он еще не был разбужен с момента последней выборки задач
+         */
+        inline void addPerformedTask(PtrTask task) {
+            performedTasksQueue.push(task);
+            if (!eventFdNotified.exchange(true))
+                eventfd_write(eventFd, 1);
+        }
+
+        inline size_t getId() const {
+            return id;
+        }
+
+        inline const PtrBuffer * getBuffers() const {
+            return buffers;
+        }
+
+        inline const PtrRequest * getRequests() const {
+            return requests;
+        }
+
+        inline size_t getMaxConnection() const {
+            return maxConnection;
+        }
+    };
+}
@@ -1,4 +1,6 @@
 #include "server.h"
+#include "reactor.h"
+#include "../response/http-date.h"
 
 using namespace std::chrono_literals;
 using json = nlohmann::json;
@@ -13,14 +15,16 @@ bool onyxup::HttpServer::isStatisticsEnable = false;
 std::string onyxup::HttpServer::statisticsUrl("^/onyxup-status-page$");
 std::string onyxup::HttpServer::pathToStaticResources;
 int onyxup::HttpServer::timeLimitRequestSeconds = 60;
+int onyxup::HttpServer::keepAliveTimeoutSeconds = 60;
 int onyxup::HttpServer::limitLocalTasks = 100;
+size_t onyxup::HttpServer::numberReactors = 1;
 bool onyxup::HttpServer::isCompressStaticResources = false;
 bool onyxup::HttpServer::isCachedStaticResources = true;
+bool onyxup::HttpServer::isWatchStaticResources = true;
+bool onyxup::HttpServer::isWarmUpStaticResources = false;
 std::string onyxup::HttpServer::pathToConfigurationFile;
 std::unordered_map<std::string, std::string> onyxup::HttpServer::mimeTypesMap;
-std::unordered_map<std::string, onyxup::ResponseBase> onyxup::HttpServer::cachedStaticResourcesMap;
-
-std::unique_ptr<onyxup::StatisticsService> statisticsService(nullptr);
+onyxup::StaticFileCache onyxup::HttpServer::staticFileCache;
 
 static json parseConfigurationFile(const std::string &filename) {
     json settings;
@@ -38,85 +42,67 @@ static json parseConfigurationFile(const std::string &filename) {
     return settings;
 }
 
-static int setNonBlockingModeSocket(int fd) {
-    int flags;
-    if (-1 == (flags = fcntl(fd, F_GETFL, 0)))
-        flags = 0;
-    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
-}
-
-int onyxup::HttpServer::writeToOutputBuffer(int fd, const char *data, size_t len) noexcept {
-    PtrBuffer buffer = buffers[fd];
-    int code = ResponseState::RESPONSE_STATE_OK_CODE;
-    if (buffer->getPosOutputBuffer() + len >= maxOutputBufferLength) {
-        buffer->clear();
-        Response413 response = Response413();
-        response.addHeader("Content-Length",
-                           std::to_string(response.getBody().size()));
-        std::string str = response.toString();
-        buffer->addDataToOutputBuffer(str.c_str(), str.size());
-        LOGD << "Превышен размер выходного буфера";
-        code = ResponseState::RESPONSE_STATE_PAYLOAD_TOO_LARGE_CODE;
-    } else
-        buffer->addDataToOutputBuffer(data, len);
-    struct epoll_event event;
-    event.data.fd = fd;
-    event.events = EPOLLOUT | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
-
-    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == -1) {
-        LOGE << "Не возможно модифицировать файловый дескриптор. Ошибка " << errno;
-        closeAllSocketsAndClearData(fd);
-        return -1;
-    }
-    return code;
-}
-
-onyxup::PtrTask onyxup::HttpServer::dispatcher(PtrRequest request) noexcept {
-    PtrRequest req = req::requestCopyFactory(request);
-    if (req) {
-        PtrTask task = taskFactory();
-        if (task) {
-            std::vector<Route>::iterator it = routes.begin();
-            while (it != routes.end()) {
-                if (it->getMethod() == req->getMethod()) {
-                    regmatch_t pm;
-                    regex_t regex = it->getPregex();
-                    if (regexec(&regex, req->getFullURIRef().c_str(), 0, &pm, 0) == 0) {
-                        task->setType(it->getTaskType());
-                        task->setRequest(req);
-                        task->setHandler(it->getHandler());
-                        return task;
-                    }
-                }
-                ++it;
-            }
-        }
-        delete req;
-        delete task;
-        return nullptr;
-    }
-    LOGE << "Не возможно создать Onyxup Request. Ошибка выделения памяти";
-    return nullptr;
+bool onyxup::HttpServer::dispatcher(PtrTask task) noexcept {
+    PtrRequest request = task->getRequest();
+    const Route * route = router.match(request->getMethodRef(), request->getFullURIRef(), request);
+    if (route == nullptr)
+        return false;
+    task->setType(route->getTaskType());
+    if (route->hasWriterHandler())
+        task->setWriterHandler(&route->getWriterHandlerRef());
+    else
+        task->setHandler(&route->getHandlerRef());
+    return true;
 }
 
-void onyxup::HttpServer::addRoute(const std::string &method, const char *regex,
-                                  std::function<ResponseBase(PtrCRequest request)> handler,
-                                  EnumTaskType task_type) noexcept {
+static std::string toUpperCase(const std::string &method) {
     std::string methodToUpperCase(method);
     std::transform(methodToUpperCase.begin(), methodToUpperCase.end(), methodToUpperCase.begin(),
                    [](unsigned char c) {
         return std::toupper(c);
     });
-    routes.push_back(Route(methodToUpperCase, regex, handler, task_type));
+    return methodToUpperCase;
+}
+
+void onyxup::HttpServer::addRoute(const std::string &method, const char *regex,
+                                  std::function<ResponseBase(PtrCRequest request)> handler,
+                                  EnumTaskType task_type) noexcept {
+    std::string methodToUpperCase = toUpperCase(method);
+    router.addRegexRoute(methodToUpperCase, regex, handler, task_type);
+    if (methodToUpperCase == "GET")
+        router.addRegexRoute("HEAD", regex, handler, task_type);
+}
+
+void onyxup::HttpServer::addRoute(const std::string &method, const char *regex, ResponseWriterHandler handler,
+                                  EnumTaskType task_type) noexcept {
+    std::string methodToUpperCase = toUpperCase(method);
+    router.addRegexRoute(methodToUpperCase, regex, handler, task_type);
     if (methodToUpperCase == "GET")
-        routes.push_back(Route("HEAD", regex, handler, task_type));
+        router.addRegexRoute("HEAD", regex, handler, task_type);
+}
+
+void onyxup::HttpServer::addPathRoute(const std::string &method, const std::string &path,
+                                      std::function<ResponseBase(PtrCRequest request)> handler,
+                                      EnumTaskType task_type) {
+    std::string methodToUpperCase = toUpperCase(method);
+    router.addPathRoute(methodToUpperCase, path, handler, task_type);
+    if (methodToUpperCase == "GET")
+        router.addPathRoute("HEAD", path, handler, task_type);
+}
+
+void onyxup::HttpServer::addPathRoute(const std::string &method, const std::string &path,
+                                      ResponseWriterHandler handler, EnumTaskType task_type) {
+    std::string methodToUpperCase = toUpperCase(method);
+    router.addPathRoute(methodToUpperCase, path, handler, task_type);
+    if (methodToUpperCase == "GET")
+        router.addPathRoute("HEAD", path, handler, task_type);
 }
 
 void onyxup::HttpServer::tasksHandler(int id) {
     
     thread_local std::shared_ptr<ResponsePrepareHeadChain> responsePrepareHeadChain (new ResponsePrepareHeadChain);
     thread_local std::shared_ptr<ResponsePrepareRangeChain> responsePrepareRangeChain (new ResponsePrepareRangeChain);
-    thread_local std::shared_ptr<ResponsePrepareCompressChain> responsePrepareCompressChain(new ResponsePrepareCompressChain(isCompressStaticResources));
+    thread_local std::shared_ptr<ResponsePrepareCompressChain> responsePrepareCompressChain(new ResponsePrepareCompressChain);
     thread_local std::shared_ptr<ResponsePrepareDefaultChain> responsePrepareDefaultChain (new ResponsePrepareDefaultChain);
     
     responsePrepareHeadChain->setNextHandler(responsePrepareRangeChain);
@@ -124,21 +110,41 @@ void onyxup::HttpServer::tasksHandler(int id) {
     responsePrepareCompressChain->setNextHandler(responsePrepareDefaultChain);
     
     while (true) {
-        PtrTask task = nullptr;
-        if (id)
-            tasksQueue.wait_and_pop(task);
-        else
-            staticTasksQueue.wait_and_pop(task);
-        if (task->getType() == EnumTaskType::LOCAL_TASK || task->getType() == EnumTaskType::STATIC_RESOURCES_TASK) {
-            ResponseBase response = task->getHandler()(task->getRequest());
-            task->setCode(response.getCode());
+        PtrTask task = scheduler->pop(id);
+        PtrRequest request = task->getRequest();
+        try {
+            if (task->getWriterHandler() != nullptr) {
+                ResponseWriter writer(task->getResponseBuffer(), request->getMethodRef() == "HEAD",
+                                      request->isClosingConnect());
+                (*task->getWriterHandler())(request, writer);
+                writer.finish();
+                task->setCode(writer.getCode());
+            } else if (task->getType() == EnumTaskType::LOCAL_TASK || task->getType() == EnumTaskType::STATIC_RESOURCES_TASK) {
+                ResponseBase response = task->getHandler()(request);
+                task->setCode(response.getCode());
+                /*
+                 * Запускаем цепочку обработчиков. У ответа 304 тела нет, Content-Length и Range к нему не относятся
+                 */
+                if (response.getCode() != ResponseState::RESPONSE_STATE_NOT_MODIFIED_CODE)
+                    responsePrepareHeadChain->execute(task, response);
+                else
+                    response.setBody("");
+                task->setResponse(response);
+            }
+        } catch (std::exception &ex) {
             /*
-             * Запускаем цепочку обработчиков
+             * Исключение обработчика (в том числе неверное использование ResponseWriter) не должно
+             * завершать сервер: записанная часть ответа отбрасывается, клиент получает 500
              */
-            responsePrepareHeadChain->execute(task, response);
-            task->setResponseData(response);
+            LOGE << "Ошибка обработчика " << request->getMethodRef() << " " << request->getFullURIRef() << ": " << ex.what();
+            ResponseWriter writer(task->getResponseBuffer(), request->getMethodRef() == "HEAD",
+                                  request->isClosingConnect());
+            writer.status(ResponseState::RESPONSE_STATE_INTERNAL_SERVER_ERROR_CODE,
+                          ResponseState::RESPONSE_STATE_INTERNAL_SERVER_ERROR_MSG);
+            writer.finish();
+            task->setCode(writer.getCode());
         }
-        performedTasksQueue.push(task);
+        task->getReactor()->addPerformedTask(task);
     }
 }
 
@@ -161,6 +167,12 @@ onyxup::HttpServer::HttpServer(int port, size_t n) : numberThreads(n) {
         } catch (json::exception &ex) {
             LOGE << "Ошибка чтения конфигурационного файла. Поле server -> threads должно быть целым";
         }
+        try {
+            if (json_server.find("reactors") != json_server.end())
+                numberReactors = settings["server"]["reactors"].get<int>();
+        } catch (json::exception &ex) {
+            LOGE << "Ошибка чтения конфигурационного файла. Поле server -> reactors должно быть целым";
+        }
         try {
             if (json_server.find("max_connection") != json_server.end())
                 maxConnection = settings["server"]["max_connection"].get<int>();
@@ -185,9 +197,15 @@ onyxup::HttpServer::HttpServer(int port, size_t n) : numberThreads(n) {
         } catch (json::exception &ex) {
             LOGE << "Ошибка чтения конфигурационного файла. Поле server -> time_limit_request_seconds должно быть целым";
         }
+        try {
+            if (json_server.find("keep_alive_timeout_seconds") != json_server.end())
+                keepAliveTimeoutSeconds = settings["server"]["keep_alive_timeout_seconds"].get<int>();
+        } catch (json::exception &ex) {
+            LOGE << "Ошибка чтения конфигурационного файла. Поле server -> keep_alive_timeout_seconds должно быть целым";
+        }
         try {
             if (json_server.find("limit_local_tasks") != json_server.end())
-                limitLocalTasks = settings["server"]["limit_local_tasks"].get<int>();
+                setLimitLocalTasks(settings["server"]["limit_local_tasks"].get<int>());
         } catch (json::exception &ex) {
             LOGE << "Ошибка чтения конфигурационного файла. Поле server -> limit_local_tasks должно быть целым";
         }
@@ -212,6 +230,24 @@ onyxup::HttpServer::HttpServer(int port, size_t n) : numberThreads(n) {
         } catch (json::exception &ex) {
             LOGE << "Ошибка чтения конфигурационного файла. Поле static-resources -> cache должно быть булевым";
         }
+        try {
+            if (json_static_resources.find("cache_max_size") != json_static_resources.end())
+                staticFileCache.setMaxSize(settings["static-resources"]["cache_max_size"].get<size_t>());
+        } catch (json::exception &ex) {
+            LOGE << "Ошибка чтения конфигурационного файла. Поле static-resources -> cache_max_size должно быть целым";
+        }
+        try {
+            if (json_static_resources.find("watch") != json_static_resources.end())
+                isWatchStaticResources = settings["static-resources"]["watch"].get<bool>();
+        } catch (json::exception &ex) {
+            LOGE << "Ошибка чтения конфигурационного файла. Поле static-resources -> watch должно быть булевым";
+        }
+        try {
+            if (json_static_resources.find("warmup") != json_static_resources.end())
+                isWarmUpStaticResources = settings["static-resources"]["warmup"].get<bool>();
+        } catch (json::exception &ex) {
+            LOGE << "Ошибка чтения конфигурационного файла. Поле static-resources -> warmup должно быть булевым";
+        }
     }
     if (settings.find("statistics") != settings.end()) {
         try {
@@ -226,474 +262,239 @@ onyxup::HttpServer::HttpServer(int port, size_t n) : numberThreads(n) {
         }
     }
 
-    buffers = new PtrBuffer[maxConnection];
-    requests = new PtrRequest[maxConnection];
-    statisticsService.reset(new StatisticsService(buffers, requests, maxConnection));
-    aliveSockets.resize(maxConnection);
-    for (size_t i = 0; i < maxConnection; i++) {
-        buffers[i] = nullptr;
-        requests[i] = nullptr;
-        aliveSockets[i] = std::chrono::steady_clock::now();
-    }
+    statisticsService.reset(new StatisticsService());
 
     mimeTypesMap = MimeType::generateMimeTypesMap();
-    if (numberThreads < 2)
-        numberThreads = 2;
+    if (numberThreads < 1)
+        numberThreads = 1;
+    if (numberReactors < 1)
+        numberReactors = 1;
+
+    /*
+     * Создаем реакторы, каждый со своим слушающим сокетом
+     */
+    for (size_t i = 0; i < numberReactors; i++) {
+        PtrReactor reactor = new Reactor(this, i, port, maxConnection);
+        reactors.push_back(reactor);
+        statisticsService->addConnectionsTable(reactor->getBuffers(), reactor->getRequests(),
+                                               reactor->getMaxConnection());
+    }
 
+    struct in_addr server_addr;
+    server_addr.s_addr = inet_addr("0.0.0.0");
+    ResponseBase::setServerAddress(std::string(inet_ntoa(server_addr)), port);
+
+    scheduler.reset(new TaskScheduler(numberThreads));
     threadsPool.resize(numberThreads);
 
     for (size_t i = 0; i < numberThreads; i++) {
         std::thread t(&HttpServer::tasksHandler, this, i);
         threadsPool[i] = std::move(t);
     }
-
-    struct sockaddr_in server_addr;
-    fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (fd < 0) {
-        LOGE << "Не возможно создать серверный сокет";
-        throw OnyxupException("Не возможно создать серверный сокет");
-    }
-    int enable = 1;
-    if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int)) < 0) {
-        close(fd);
-        LOGE << "Не возможно создать серверный сокет. Ошибка " << errno;
-        throw OnyxupException("Не возможно создать серверный сокет");
-    }
-    if (setNonBlockingModeSocket(fd) == -1) {
-        LOGE << "Не возможно создать серверный сокет. Ошибка " << errno;
-        throw OnyxupException("Не возможно создать серверный сокет");
-    }
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = inet_addr("0.0.0.0");
-    server_addr.sin_port = htons(port);
-
-    if (bind(fd, (struct sockaddr *) &server_addr, sizeof(server_addr)) < 0) {
-        close(fd);
-        LOGE << "Не возможно выполнить операцию bind. Ошибка " << errno;
-        throw OnyxupException("Не возможно создать серверный сокет");
-    }
-
-    if (listen(fd, SOMAXCONN) < 0) {
-        LOGE << "Не возможно выполнить операцию listen. Ошибка " << errno;
-        throw OnyxupException("Не возможно создать серверный сокет");
-    };
-
-    epollFd = epoll_create1(0);
-    if (epollFd == -1) {
-        close(fd);
-        LOGE << "Не возможно создать epoll. Ошибка " << errno;
-        throw OnyxupException("Не возможно создать серверный сокет");
-    }
-
-    struct epoll_event event;
-    event.data.fd = fd;
-    event.events = EPOLLIN;
-
-    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
-    
-    ResponseBase::SERVER_PORT = port;
-    ResponseBase::SERVER_IP = std::string(inet_ntoa(server_addr.sin_addr));
 }
 
 void onyxup::HttpServer::run() noexcept {
-    sockaddr_in peer_addr;
-    int address_length = sizeof(peer_addr);
-    struct epoll_event events[maxEventsEpoll];
-    struct epoll_event event;
-
     /*
      * Подключение сбора статистики
      */
     if (isStatisticsEnable) {
-        this->addRoute("GET", statisticsUrl.c_str(), [](PtrCRequest request) -> ResponseBase {
+        this->addRoute("GET", statisticsUrl.c_str(), [this](PtrCRequest request) -> ResponseBase {
             return statisticsService->callback(request);
         }, EnumTaskType::LOCAL_TASK);
     }
 
-    for (;;) {
-        static size_t counter_check_limit_time_request = 0;
-        std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
-
-        if (isStatisticsEnable)
-            statisticsService->setCurrentNumberTasks(tasksQueue.size() + staticTasksQueue.size());
-        for (size_t i = counter_check_limit_time_request;
-             i < maxConnection && i < counter_check_limit_time_request + 100; i++) {
-            if (requests[i]) {
-                if (std::chrono::duration_cast<std::chrono::seconds>(now - aliveSockets[i]).count() >
-                    HttpServer::timeLimitRequestSeconds) {
-                    if (requests[i]->getFullURIRef().empty())
-                        closeAllSocketsAndClearData(requests[i]->getFD());
-                    else {
-                        ResponseBase response = std::move(onyxup::Response408());
-                        response.addHeader("Content-Length", std::to_string(response.getBody().size()));
-                        std::string str = response.toString();
-                        writeToOutputBuffer(requests[i]->getFD(), str.c_str(), str.length());
-                        requests[i]->setClosingConnect(true);
-                        aliveSockets[requests[i]->getFD()] = std::chrono::steady_clock::now();
-                        LOGI << requests[i]->getMethod() << " " << requests[i]->getFullURIRef() << " "
-                             << ResponseState::RESPONSE_STATE_METHOD_REQUEST_TIMEOUT_CODE;
-                    }
-                }
-            }
-        }
-        counter_check_limit_time_request = (counter_check_limit_time_request + 100) % maxConnection;
-
-        while (!performedTasksQueue.empty()) {
-            PtrTask task = nullptr;
-            if (performedTasksQueue.try_pop(task)) {
-                /*
-                 * Проверяем что данный сокет еще жив
-                */
-                if (task->getTimePoint() == aliveSockets[task->getFD()]) {
-                    int code = writeToOutputBuffer(task->getFD(), task->getResponseData().c_str(),
-                                                   task->getResponseData().size());
-                    if (code == ResponseState::RESPONSE_STATE_PAYLOAD_TOO_LARGE_CODE)
-                        LOGI << task->getRequest()->getMethod() << " " << task->getRequest()->getFullURIRef() << " "
-                             << ResponseState::RESPONSE_STATE_PAYLOAD_TOO_LARGE_CODE;
-                    else LOGI << task->getRequest()->getMethod() << " " << task->getRequest()->getFullURIRef() << " "
-                                  << task->getCode();
-                }
-                delete task;
-            }
-        }
-        int fds = epoll_wait(epollFd, events, maxEventsEpoll, 100);
-        for (int i = 0; i < fds; i++) {
-            if ((events[i].events & EPOLLERR) || (events[i].events & EPOLLHUP) || (events[i].events & EPOLLRDHUP)) {
-                closeAllSocketsAndClearData(events[i].data.fd);
-                continue;
-            }
-            if (events[i].data.fd == fd) {
-                int conn_sock = accept(fd, (struct sockaddr *) &peer_addr, (socklen_t *) &address_length);
-                if (conn_sock > (int) maxConnection - 1) {
-                    closeSocket(conn_sock);
-                    LOGE << "Превышено максимальное количество соединений на сервере";
-                    continue;
-                }
-                if (conn_sock == -1) {
-                    closeSocket(conn_sock);
-                    LOGE << "Не возможно принять соединение на сервере. Ошибка " << errno;
-                    continue;
-                }
-                if (setNonBlockingModeSocket(conn_sock) == -1) {
-                    closeSocket(conn_sock);
-                    LOGE << "Не возможно перевести сокет в неблокирующий режим. Ошибка " << errno;
-                    continue;
-                }
-                event.events = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
-                event.data.fd = conn_sock;
-                if (epoll_ctl(epollFd, EPOLL_CTL_ADD, conn_sock, &event) == -1) {
-                    closeSocket(conn_sock);
-                    LOGE << "Не возможно добавить файловый дескриптор в epoll. Ошибка " << errno;
-                    continue;
-                }
-
-                if (isStatisticsEnable)
-                    statisticsService->addTotalNumberConnectionsAccepted();
-
-                aliveSockets[conn_sock] = std::chrono::steady_clock::now();
-
-                /*
-                 * Подготавливаем входной и выходной буфер, выделяем память
-                 */
-                buffers[conn_sock] = buffer::bufferFactory(maxInputBufferLength, maxOutputBufferLength);
-                if (buffers[conn_sock] == nullptr) {
-                    LOGE << "Ошибка выделение памяти";
-                    closeSocket(conn_sock);
-                    continue;
-                }
+    /*
+     * Изменения файлов на диске обновляют кеш статических ресурсов без перезапуска
+     */
+    if (isCachedStaticResources && isWatchStaticResources && !pathToStaticResources.empty()) {
+        staticFileWatcher.reset(new StaticFileWatcher(staticFileCache, pathToStaticResources));
+        if (!staticFileWatcher->start())
+            staticFileWatcher.reset();
+    }
 
-                /*
-                 * Подготавливаем req
-                 */
+    /*
+     * Кеш заполняется до приема соединений, наблюдение уже запущено и не пропустит изменения во время прогрева
+     */
+    if (isCachedStaticResources && isWarmUpStaticResources && !pathToStaticResources.empty())
+        warmUpStaticResources();
 
-                requests[conn_sock] = req::requestFactory();
-                if (requests[conn_sock] == nullptr) {
-                    closeSocket(conn_sock);
-                    delete buffers[conn_sock];
-                    buffers[conn_sock] = nullptr;
-                    continue;
-                }
-                requests[conn_sock]->setFD(conn_sock);
-                requests[conn_sock]->setMaxOutputLengthBuffer(maxOutputBufferLength);
-            } else {
-                if (events[i].events & EPOLLIN) {
-                    char data[4096];
-                    int res = recv(events[i].data.fd, data, sizeof(data), 0);
-                    if (res == -1) {
-                        if (errno != EWOULDBLOCK && errno != EINPROGRESS) {
-                            LOGE << "Не возможно прочитать данные из сокета. Ошибка " << errno;
-                            closeAllSocketsAndClearData(events[i].data.fd);
-                            continue;
-                        }
-                    }
-                    if (res == 0) {
-                        closeAllSocketsAndClearData(events[i].data.fd);
-                        continue;
-                    }
-                    PtrBuffer buffer = buffers[events[i].data.fd];
-                    if (buffer->getPosInputBuffer() + res >= maxInputBufferLength) {
-                        LOGD << "Превышен размер входного буфера";
-
-                        Response413 response = Response413();
-                        response.addHeader("Content-Length",
-                                           std::to_string(response.getBody().size()));
-                        std::string str = response.toString();
-                        writeToOutputBuffer(events[i].data.fd, str.c_str(), str.length());
-                        requests[events[i].data.fd]->setClosingConnect(true);
-                        requests[events[i].data.fd]->setHeaderAccept(true);
-                        continue;
-                    }
-                    buffer->addDataToInputBuffer(data, res);
-                    /*
-                     * Парсим http запрос
-                     */
-
-                    const char *method, *uri;
-                    phr_header headers[100];
-                    size_t method_len, uri_len;
-                    int version;
-                    size_t num_headers = sizeof(headers) / sizeof(headers[0]);
-                    int parse_http_result = phr_parse_request(buffer->getInputBuffer(),
-                                                              buffer->getPosInputBuffer() + 1,
-                                            &method,
-                                            &method_len, &uri, &uri_len, &version, headers,
-                                            &num_headers, 0);
-                    if (parse_http_result > 0) {
-                        PtrRequest request = requests[events[i].data.fd];
-
-                        if (!request->isHeaderAccept()) {
-                            request->setHeaderAccept(true);
-                            request->setFullURI(uri, uri_len);
-                            request->setMethod(method, method_len);
-
-                            for (size_t j = 0; j < num_headers; j++) {
-                                std::string key(headers[j].name, (int) headers[j].name_len);
-                                std::transform(key.begin(), key.end(), key.begin(), tolower);
-                                std::string value(headers[j].value, (int) headers[j].value_len);
-                                request->addHeader(key, value);
-                            }
-                            /*
-                             * Получаем параметры строки запроса
-                             */
-                            utils::parseParamsRequest(request, uri_len);
-
-                            /*
-                             * Определяем должен ли запрос содержать тело
-                             */
-                            try {
-                                std::string header_content_length = request->getHeaderRef("content-length");
-                                int len = atoi(header_content_length.c_str());
-                                if (len)
-                                    request->setBodyExists(true);
-                            } catch (std::out_of_range &ex) {
-                            }
-                        }
-
-                        /*
-                         * Получаем тело запроса
-                         */
-                        if (request->isBodyExists()) {
-                            try {
-                                std::string header_content_length = request->getHeaderRef("content-length");
-                                int len = atoi(header_content_length.c_str());
-                                if (len && buffer->getPosInputBuffer() == (parse_http_result + len)) {
-                                    request->setBodyAccept(true);
-                                    request->setBody(buffer->getInputBuffer() + parse_http_result, len);
-                                }
-                            } catch (std::out_of_range &ex) {
-                                closeAllSocketsAndClearData(events[i].data.fd);
-                                continue;
-                            }
-                            if (!request->isBodyAccept())
-                                continue;
-                        }
-
-                        if ((request->isBodyExists() && request->isBodyAccept()) || !request->isBodyExists()) {
-                            struct epoll_event event;
-                            event.data.fd = events[i].data.fd;
-                            event.events = EPOLLERR | EPOLLHUP | EPOLLRDHUP;
-                            if (epoll_ctl(epollFd, EPOLL_CTL_MOD, events[i].data.fd, &event) == -1) {
-                                LOGE << "Не возможно модифицировать файловый дескриптор в epoll. Ошибка " << errno;
-                                closeAllSocketsAndClearData(events[i].data.fd);
-                                continue;
-                            }
-                        }
-
-                        /*
-                         * Запускаем dispatcher
-                         */
-                        PtrTask task = dispatcher(request);
-                        if (task) {
-                            task->setFD(events[i].data.fd);
-                            task->setTimePoint(aliveSockets[events[i].data.fd]);
-                            /*
-                             * В зависимости от типа задачи направляем в соответствующий поток
-                             */
-                            if (task->getType() == EnumTaskType::LOCAL_TASK) {
-                                if (tasksQueue.size() > HttpServer::limitLocalTasks) {
-                                    ResponseBase response = onyxup::Response503();
-                                    response.addHeader("Content-Length",
-                                                       std::to_string(response.getBody().size()));
-                                    std::string str = response.toString();
-                                    writeToOutputBuffer(events[i].data.fd, str.c_str(), str.size());
-                                    LOGI << request->getMethod() << " " << request->getFullURIRef() << " "
-                                         << ResponseState::RESPONSE_STATE_SERVICE_UNAVAILABLE_CODE;
-                                    delete task;
-                                } else
-                                    addTask(task);
-                            } else if (task->getType() == EnumTaskType::STATIC_RESOURCES_TASK) {
-                                addTask(task);
-                            } else {
-                                LOGE << "Не известный тип задачи";
-                                delete task;
-                                closeAllSocketsAndClearData(events[i].data.fd);
-                            }
-                            statisticsService->addTotalNumberClientRequests();
-                        } else {
-                            ResponseBase response = onyxup::Response404();
-                            response.addHeader("Content-Length", std::to_string(response.getBody().size()));
-                            std::string str = response.toString();
-                            writeToOutputBuffer(events[i].data.fd, str.c_str(), str.size());
-                            LOGI << request->getMethod() << " " << request->getFullURIRef() << " "
-                                 << ResponseState::RESPONSE_STATE_NOT_FOUND_CODE;
-                            statisticsService->addTotalNumberClientRequests();
-                        }
-                        continue;
-                    } else if (parse_http_result == -2) {
-                        continue;
-                    } else if (parse_http_result == -1) {
-                        LOGE << "Ошибка разбора HTTP запроса";
-                        closeAllSocketsAndClearData(events[i].data.fd);
-                        continue;
-                    }
-                }
-                if (events[i].events & EPOLLOUT && buffers[events[i].data.fd]->getBytesToSend() > 0 &&
-                    requests[events[i].data.fd]->isHeaderAccept()) {
-                    if (requests[events[i].data.fd]->isBodyExists() &&
-                        !requests[events[i].data.fd]->isBodyAccept())
-                        continue;
-                    PtrBuffer buffer = buffers[events[i].data.fd];
-                    int res = send(events[i].data.fd, buffer->getOutputBuffer() + buffer->getPosOutputBuffer(),
-                                   buffer->getBytesToSend(), 0);
-                    if (res == -1) {
-                        closeAllSocketsAndClearData(events[i].data.fd);
-                        continue;
-                    }
-                    buffer->setBytesToSend(buffer->getBytesToSend() - res);
-                    buffer->setPosOutputBuffer(buffer->getPosOutputBuffer() + res);
-                    if (buffer->getBytesToSend() == 0) {
-                        try {
-                            if (requests[events[i].data.fd]->isClosingConnect()) {
-                                closeAllSocketsAndClearData(events[i].data.fd);
-                            } else if (requests[events[i].data.fd]->getHeader("connection") == "Keep-Alive") {
-                                buffers[events[i].data.fd]->clear();
-                                requests[events[i].data.fd]->clear();
-                                struct epoll_event event;
-                                event.data.fd = events[i].data.fd;
-                                event.events = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
-                                if (epoll_ctl(epollFd, EPOLL_CTL_MOD, events[i].data.fd, &event) == -1) {
-                                    closeAllSocketsAndClearData(events[i].data.fd);
-                                    LOGE << "Не возможно модифицировать файловый дескриптор в epoll. Ошибка " << errno;
-                                    continue;
-                                }
-                                aliveSockets[events[i].data.fd] = std::chrono::steady_clock::now();
-                            } else
-                                closeAllSocketsAndClearData(events[i].data.fd);
-                        } catch (std::out_of_range &ex) {
-                            closeAllSocketsAndClearData(events[i].data.fd);
-                        }
-                    }
-                }
-            }
-        }
+    /*
+     * Запускаем реакторы в отдельных потоках, нулевой реактор работает в текущем потоке
+     */
+    reactorsPool.resize(reactors.size() - 1);
+    for (size_t i = 1; i < reactors.size(); i++) {
+        std::thread t(&Reactor::run, reactors[i]);
+        reactorsPool[i - 1] = std::move(t);
     }
+    reactors[0]->run();
 }
 
 onyxup::HttpServer::~HttpServer() {
     for (size_t i = 0; i < numberThreads; i++)
         threadsPool[i].join();
 
-    for (size_t i = 0; i < maxConnection; i++)
-        closeAllSocketsAndClearData(i);
-    shutdown(fd, SHUT_RD);
-    close(fd);
-    delete[] buffers;
-    delete[] requests;
+    for (auto &thread : reactorsPool)
+        thread.join();
+
+    for (auto reactor : reactors)
+        delete reactor;
 }
 
-onyxup::ResponseBase onyxup::HttpServer::defaultStaticResourcesCallback(onyxup::PtrCRequest request) {
-    /*
-     * Определяем content type по расширению файла
-     */
-    char content_type_key[10] = {'\0'};
-    char *token_dot = strrchr((char *) request->getFullURIRef().c_str(), '.');
-    if (token_dot == NULL)
-        return onyxup::Response404();
-    if (strlen(token_dot + 1) > sizeof(content_type_key) - 1) {
-        return onyxup::Response404();
-    }
-    strcat(content_type_key, token_dot + 1);
-    std::unordered_map<std::string, std::string>::iterator it = mimeTypesMap.find(
-                content_type_key);
-    if (it == mimeTypesMap.end()) {
-        return onyxup::Response404();
+/*
+ * Условный запрос (RFC 7232): If-None-Match сравнивается с ETag, If-Modified-Since учитывается
+ * только без If-None-Match. Дата в неизвестном формате игнорируется
+ */
+static bool isNotModified(onyxup::PtrCRequest request, const onyxup::PtrStaticFile &file) {
+    std::optional<std::string_view> if_none_match = request->findHeader(onyxup::HttpHeader::IF_NONE_MATCH);
+    if (if_none_match)
+        return onyxup::utils::matchETag(*if_none_match, file->getETag());
+    std::optional<std::string_view> if_modified_since = request->findHeader(onyxup::HttpHeader::IF_MODIFIED_SINCE);
+    time_t since;
+    return if_modified_since && onyxup::HttpDate::parse(*if_modified_since, since) &&
+           file->getModificationTime() <= since;
+}
+
+static bool acceptsGzip(onyxup::PtrCRequest request) {
+    std::optional<std::string_view> accept_encoding = request->findHeader(onyxup::HttpHeader::ACCEPT_ENCODING);
+    return accept_encoding && accept_encoding->find("gzip") != std::string_view::npos;
+}
+
+const std::string *onyxup::HttpServer::findMimeType(std::string_view path) {
+    size_t dot = path.rfind('.');
+    if (dot == std::string_view::npos || path.find('/', dot) != std::string_view::npos)
+        return nullptr;
+    auto it = mimeTypesMap.find(std::string(path.substr(dot + 1)));
+    return it == mimeTypesMap.end() ? nullptr : &it->second;
+}
+
+/*
+ * Собирает обычные файлы каталога root + relative и его подкаталогов: путь относительно root и размер
+ */
+static void collectStaticFiles(const std::string &root, const std::string &relative,
+                               std::vector<std::pair<std::string, size_t>> &files) {
+    DIR *dir = opendir((root + relative).c_str());
+    if (dir == nullptr)
+        return;
+    while (struct dirent *entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        std::string child = relative + "/" + entry->d_name;
+        struct stat st;
+        if (stat((root + child).c_str(), &st) == -1)
+            continue;
+        if (S_ISDIR(st.st_mode) && entry->d_type != DT_LNK)
+            collectStaticFiles(root, child, files);
+        else if (S_ISREG(st.st_mode))
+            files.emplace_back(child, (size_t) st.st_size);
     }
+    closedir(dir);
+}
 
+void onyxup::HttpServer::warmUpStaticResources() {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, size_t>> files;
+    collectStaticFiles(pathToStaticResources, "", files);
+    files.erase(std::remove_if(files.begin(), files.end(), [](const std::pair<std::string, size_t> &file) {
+        return findMimeType(file.first) == nullptr;
+    }), files.end());
     /*
-     * Проверяем кеш иначе получаем ресурс и заносим в кеш
+     * Сначала мелкие файлы: в бюджет кеша их попадает больше
      */
-    if (isCachedStaticResources) {
-        std::unordered_map<std::string, ResponseBase>::iterator iter = cachedStaticResourcesMap.find(
-                    request->getURIRef());
-        if (iter == cachedStaticResourcesMap.end()) {
-            char path_to_file[120];
-            snprintf(path_to_file, sizeof(path_to_file), "%s%s",
-                     pathToStaticResources.c_str(), request->getURIRef().c_str());
-
-            std::ifstream file(path_to_file, std::ios::in | std::ifstream::binary);
-            if (file.good()) {
-                std::string buf = std::string((std::istreambuf_iterator<char>(file)),
-                                              std::istreambuf_iterator<char>());
-                file.close();
-                ResponseBase response(ResponseState::RESPONSE_STATE_OK_CODE, ResponseState::RESPONSE_STATE_OK_MSG,
-                                      it->second.c_str(), buf);
-                /*
-                 * Отправляем данные в кеш
-                 */
-                cachedStaticResourcesMap[request->getURIRef()] = response;
-                return response;
-            } else {
-                return onyxup::Response404();
-            }
-        } else {
+    std::sort(files.begin(), files.end(), [](const std::pair<std::string, size_t> &a, const std::pair<std::string, size_t> &b) {
+        return a.second < b.second;
+    });
+    size_t max_size = staticFileCache.getMaxSize();
+    /*
+     * Сжатый вариант занимает в кеше отдельную запись. Файлы сверх числа записей кеша
+     * вытеснили бы загруженные раньше, поэтому прогрев останавливается на лимите
+     */
+    size_t entries_per_file = isCompressStaticResources ? 2 : 1;
+    size_t max_entries = staticFileCache.getMaxFiles();
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> entries(0);
+    std::atomic<size_t> loaded(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < files.size(); i = next++) {
+            if (staticFileCache.getCurrentSize() + files[i].second > max_size)
+                break;
+            if (entries.fetch_add(entries_per_file) + entries_per_file > max_entries)
+                break;
             /*
-             * Берем из кеша
+             * Ключ строится так же, как в defaultStaticResourcesCallback, иначе запросы не попадут в прогретые записи
              */
-            ResponseBase response = cachedStaticResourcesMap[request->getURIRef()];
-            return response;
+            std::string path;
+            if (!StaticFileCache::makeKey(pathToStaticResources, files[i].first, path))
+                continue;
+            PtrStaticFile file = staticFileCache.get(path);
+            if (file == nullptr)
+                continue;
+            if (isCompressStaticResources)
+                staticFileCache.getCompressed(path, file);
+            if (file->isInMemory())
+                loaded++;
         }
-    } else {
-        char path_to_file[120];
-        snprintf(path_to_file, sizeof(path_to_file), "%s%s",
-                 pathToStaticResources.c_str(), request->getURIRef().c_str());
+    };
+    std::vector<std::thread> threads(numberThreads);
+    for (auto &thread : threads)
+        thread = std::thread(worker);
+    for (auto &thread : threads)
+        thread.join();
+    LOGI << "Прогрев кеша статических ресурсов: загружено " << loaded << " из " << files.size() << " файлов, "
+         << "в кеше " << staticFileCache.size() << " записей, " << staticFileCache.getCurrentSize() << " байт за "
+         << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+         << " мс";
+}
 
-        std::ifstream file(path_to_file, std::ios::in | std::ifstream::binary);
-        if (file.good()) {
-            std::string buf = std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-            file.close();
+onyxup::ResponseBase onyxup::HttpServer::defaultStaticResourcesCallback(onyxup::PtrCRequest request) {
+    /*
+     * Определяем content type по расширению файла
+     */
+    std::string_view uri = request->getURIRef();
+    const std::string *mime_type = findMimeType(uri);
+    if (mime_type == nullptr)
+        return onyxup::Response404();
 
-            ResponseBase response(ResponseState::RESPONSE_STATE_OK_CODE, ResponseState::RESPONSE_STATE_OK_MSG,
-                                  it->second.c_str(), buf);
-            /*
-             * Отправляем данные в кеш
-             */
-            cachedStaticResourcesMap[request->getURIRef()] = response;
-            return response;
-        } else {
-            return onyxup::Response404();
+    /*
+     * Путь приводится к единому виду: //app.js и /./app.js - тот же файл и та же запись кеша,
+     * что и /app.js. Сегмент ".." позволил бы выйти за каталог статических ресурсов
+     */
+    std::string path_to_file;
+    if (!StaticFileCache::makeKey(pathToStaticResources, uri, path_to_file))
+        return onyxup::Response404();
+
+    /*
+     * Файл не читается: телом ответа становится отображение из кеша или открытый дескриптор,
+     * реактор отправит его без копирования
+     */
+    PtrStaticFile file = isCachedStaticResources ? staticFileCache.get(path_to_file) : StaticFile::open(path_to_file);
+    if (file == nullptr)
+        return onyxup::Response404();
+    /*
+     * Клиенту, принимающему gzip, отдаем готовый файл .gz или вариант, сжатый один раз и сохраненный в кеше.
+     * Без кеша вариант сжимается на каждый запрос, поэтому с обычной, а не максимальной степенью
+     */
+    bool compressed = false;
+    if (isCompressStaticResources && acceptsGzip(request)) {
+        PtrStaticFile variant = isCachedStaticResources ? staticFileCache.getCompressed(path_to_file, file)
+                                                        : StaticFile::openCompressed(path_to_file, *file);
+        if (variant != nullptr) {
+            file = std::move(variant);
+            compressed = true;
         }
     }
-
+    bool not_modified = isNotModified(request, file);
+    ResponseBase response(not_modified ? ResponseState::RESPONSE_STATE_NOT_MODIFIED_CODE : ResponseState::RESPONSE_STATE_OK_CODE,
+                          not_modified ? ResponseState::RESPONSE_STATE_NOT_MODIFIED_MSG : ResponseState::RESPONSE_STATE_OK_MSG,
+                          mime_type->c_str());
+    response.addHeader("ETag", file->getETag());
+    response.addHeader("Last-Modified", file->getLastModified());
+    if (isCompressStaticResources)
+        response.addHeader("Vary", "Accept-Encoding");
+    if (compressed)
+        response.addHeader("Content-Encoding", "gzip");
+    if (!not_modified)
+        response.setFile(std::move(file));
+    return response;
 }
 
 int onyxup::HttpServer::getTimeLimitRequestSeconds() {
@@ -704,16 +505,45 @@ void onyxup::HttpServer::setTimeLimitRequestSeconds(int limit) {
     timeLimitRequestSeconds = limit;
 }
 
+int onyxup::HttpServer::getKeepAliveTimeoutSeconds() {
+    return keepAliveTimeoutSeconds;
+}
+
+void onyxup::HttpServer::setKeepAliveTimeoutSeconds(int timeout) {
+    keepAliveTimeoutSeconds = timeout;
+}
+
 int onyxup::HttpServer::getLimitLocalTasks() {
     return limitLocalTasks;
 }
 
 void onyxup::HttpServer::setLimitLocalTasks(int limit) {
+    /*
+     * Отрицательный предел при сравнении с размером очереди стал бы огромным и отключил бы ограничение
+     */
+    if (limit < 0) {
+        LOGE << "Предел локальных задач не может быть отрицательным: " << limit;
+        return;
+    }
     limitLocalTasks = limit;
 }
 
 void onyxup::HttpServer::setCachedStaticResources(bool flag) {
     isCachedStaticResources = flag;
+    if (!flag)
+        staticFileCache.clear();
+}
+
+void onyxup::HttpServer::setStaticResourcesCacheSize(size_t size) {
+    staticFileCache.setMaxSize(size);
+}
+
+void onyxup::HttpServer::setWatchStaticResources(bool flag) {
+    isWatchStaticResources = flag;
+}
+
+void onyxup::HttpServer::setWarmUpStaticResources(bool flag) {
+    isWarmUpStaticResources = flag;
 }
 
 void onyxup::HttpServer::setPathToConfigurationFile(const std::string &file) {
@@ -728,15 +558,8 @@ void onyxup::HttpServer::setStatisticsUrl(const std::string &url) {
     statisticsUrl = url;
 }
 
-void onyxup::HttpServer::closeAllSocketsAndClearData(int fd) {
-    shutdown(fd, SHUT_RDWR);
-    close(fd);
-    delete buffers[fd];
-    delete requests[fd];
-    aliveSockets[fd] = std::chrono::steady_clock::now();
-    buffers[fd] = nullptr;
-    requests[fd] = nullptr;
-    statisticsService->addTotalNumberConnectionsProcessed();
+void onyxup::HttpServer::setNumberReactors(size_t n) {
+    numberReactors = n;
 }
 
 void onyxup::HttpServer::setMaxInputBufferLength(size_t len) {
@@ -14,6 +14,8 @@
 #include <errno.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <dirent.h>
 #include <signal.h>
 #include <pthread.h>
 #include <time.h>
@@ -28,14 +30,18 @@
 #include <chrono>
 #include <atomic>
 #include <queue>
+#include <algorithm>
 
 #include "utils.h"
 #include "../buffer/buffer.h"
 #include "../request/request.h"
 #include "../exception/exception.h"
 #include "../route/route.h"
+#include "../route/router.h"
 #include "../task/task.h"
 #include "../mime/types.h"
+#include "../static/static-file-cache.h"
+#include "../static/static-file-watcher.h"
 #include "../httpparser/picohttpparser.h"
 #include "../response/chains/ResponsePrepareHeadChain.h"
 #include "../response/chains/ResponsePrepareRangeChain.h"
@@ -46,10 +52,11 @@
 #include "../response/response-408.h"
 #include "../response/response-503.h"
 #include "../response/response-base.h"
+#include "../response/response-writer.h"
 #include "../response/response-states.h"
 #include "../plog/Log.h"
 #include "../plog/Appenders/ColorConsoleAppender.h"
-#include "../queue/thread-safe-queue.h"
+#include "../scheduler/task-scheduler.h"
 #include "../json/json.hpp"
 #include "../services/statistics/StatisticsService.h"
 
@@ -80,55 +87,75 @@ namespace onyxup {
         }
     };
 
+    class Reactor;
+
     class HttpServer {
+        friend class Reactor;
     private:
-        int fd;
-        int epollFd;
         size_t numberThreads;
         std::vector<std::thread> threadsPool;
+        std::vector<Reactor *> reactors;
+        std::vector<std::thread> reactorsPool;
 
         size_t maxConnection = 10000;
-        size_t maxEventsEpoll = 100;
         size_t maxInputBufferLength = 1024 * 1024 * 2;
+        /*
+         * Объем готовых, но не принятых сокетом ответов соединения, при котором реактор
+         * перестает читать из него новые запросы. Размер отдельного ответа не ограничивает
+         */
         size_t maxOutputBufferLength = 1024 * 1024 * 75;
-        PtrBuffer * buffers;
-        PtrRequest * requests;
-        std::vector<std::chrono::time_point<std::chrono::steady_clock>> aliveSockets;
 
-        std::vector<Route> routes;
+        Router router;
+
+        std::unique_ptr<TaskScheduler> scheduler;
 
-        ThreadSafeQueue<PtrTask> tasksQueue;
-        ThreadSafeQueue<PtrTask> staticTasksQueue;
-        ThreadSafeQueue<PtrTask> performedTasksQueue;
+        std::unique_ptr<StatisticsService> statisticsService;
+
+        std::unique_ptr<StaticFileWatcher> staticFileWatcher;
 
         static bool isStatisticsEnable;
         static std::string statisticsUrl;
         static int timeLimitRequestSeconds;
+        static int keepAliveTimeoutSeconds;
         static int limitLocalTasks;
+        static size_t numberReactors;
         static std::string pathToStaticResources;
         static bool isCompressStaticResources;
         static bool isCachedStaticResources;
+        static bool isWatchStaticResources;
+        static bool isWarmUpStaticResources;
         static std::string pathToConfigurationFile;
         static std::unordered_map<std::string, std::string> mimeTypesMap;
-        static std::unordered_map<std::string, ResponseBase> cachedStaticResourcesMap;
-
-        void closeAllSocketsAndClearData(int fd);
-
-        inline void closeSocket(int fd) {
-            shutdown(fd, SHUT_RDWR);
-            close(fd);
-        }
-
-        inline void addTask(PtrTask task) {
-            if(task->getType() == EnumTaskType::LOCAL_TASK)
-                tasksQueue.push(task);
-            else if(task->getType() == EnumTaskType::STATIC_RESOURCES_TASK)
-                staticTasksQueue.push(task);
+        /*
+         * Отображенные в память статические ресурсы, используется при isCachedStaticResources
+         */
+        static StaticFileCache staticFileCache;
+
+        /*
+         * MIME-тип по расширению файла, nullptr для неизвестного расширения
+         */
+        static const std::string * findMimeType(std::string_view path);
+
+        /*
+         * Параллельно, по потоку на рабочий поток сервера, загружает файлы каталога статических ресурсов
+         * (с ETag и сжатыми вариантами) в кеш, начиная с мелких, пока они помещаются в бюджет кеша
+         * по размеру и по числу записей
+         */
+        void warmUpStaticResources();
+
+        /*
+         * Возвращает false, если очередь задач заполнена
+         */
+        inline bool addTask(PtrTask task) {
+            return scheduler->push(task);
         }
 
         void tasksHandler(int id);
-        int writeToOutputBuffer(int fd, const char * data, size_t len) noexcept ;
-        PtrTask dispatcher(PtrRequest request) noexcept;
+        /*
+         * Находит маршрут запроса задачи, обработчик задача получает по ссылке на маршрут.
+         * Возвращает false, если маршрута нет
+         */
+        bool dispatcher(PtrTask task) noexcept;
 
     public:
         
@@ -140,6 +167,24 @@ namespace onyxup {
         void run() noexcept ;
         void addRoute(const std::string & method, const char * regex, std::function<ResponseBase(PtrCRequest request) > handler, EnumTaskType type) noexcept ;
 
+        /*
+         * Маршрут с обработчиком, который записывает ответ через ResponseWriter
+         * сразу в буфер задачи, без промежуточного ResponseBase
+         */
+        void addRoute(const std::string & method, const char * regex, ResponseWriterHandler handler, EnumTaskType type) noexcept ;
+
+        /*
+         * Маршрут по шаблону пути, например /users/{id:int}/posts/{slug}.
+         * Значения параметров доступны через Request::getPathParams()
+         */
+        void addPathRoute(const std::string & method, const std::string & path, std::function<ResponseBase(PtrCRequest request) > handler, EnumTaskType type);
+
+        void addPathRoute(const std::string & method, const std::string & path, ResponseWriterHandler handler, EnumTaskType type);
+
+        /*
+         * Файлы в каталоге обновляются через rename (или замену каталога целиком): закешированные
+         * файлы отображены в память, и файл, перезаписанный на месте, может быть отдан частично
+         */
         static void setPathToStaticResources(const std::string & path) {
             pathToStaticResources = path;
         }
@@ -158,18 +203,45 @@ namespace onyxup {
 
         static void setTimeLimitRequestSeconds(int limit);
 
+        /*
+         * Время, которое соединение keep-alive может простаивать между запросами
+         */
+        static int getKeepAliveTimeoutSeconds();
+
+        static void setKeepAliveTimeoutSeconds(int timeout);
+
         static int getLimitLocalTasks();
 
         static void setLimitLocalTasks(int limit);
 
         static void setCachedStaticResources(bool flag);
 
+        /*
+         * Ограничение на суммарный размер закешированных статических ресурсов в байтах
+         */
+        static void setStaticResourcesCacheSize(size_t size);
+
+        /*
+         * Обновлять кеш статических ресурсов при изменении файлов на диске (inotify), по умолчанию включено
+         */
+        static void setWatchStaticResources(bool flag);
+
+        /*
+         * Заполнять кеш статических ресурсов при запуске сервера, по умолчанию выключено
+         */
+        static void setWarmUpStaticResources(bool flag);
+
         static void setPathToConfigurationFile(const std::string &file);
 
         static void setStatisticsEnable(bool enable);
 
         static void setStatisticsUrl(const std::string & url);
 
+        /*
+         * Количество реакторов (потоков epoll), задается до создания сервера
+         */
+        static void setNumberReactors(size_t n);
+
         void setMaxInputBufferLength(size_t len);
 
         void setMaxOutputBufferLength(size_t len);
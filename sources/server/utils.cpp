@@ -58,17 +58,15 @@ std::unordered_map<std::string, std::string> onyxup::utils::urlencoded(const std
 std::unordered_map<std::string, onyxup::MultipartFormDataObject> onyxup::utils::multipartFormData(PtrCRequest request) {
     std::unordered_map<std::string, MultipartFormDataObject> fields;
     std::string boundary;
-    try {
-        std::string content_type = request->getHeaderRef("content-type");
-        size_t pos = content_type.find("boundary=");
-        if (content_type.find("multipart/form-data") == std::string::npos || pos == std::string::npos)
-            return fields;
-        boundary = content_type.substr(pos + strlen("boundary="));
-        if (boundary.empty())
-            return fields;
-    } catch (std::out_of_range) {
+    std::optional<std::string_view> content_type = request->findHeader(HttpHeader::CONTENT_TYPE);
+    if (!content_type)
+        return fields;
+    size_t boundary_pos = content_type->find("boundary=");
+    if (content_type->find("multipart/form-data") == std::string_view::npos || boundary_pos == std::string_view::npos)
+        return fields;
+    boundary = std::string(content_type->substr(boundary_pos + strlen("boundary=")));
+    if (boundary.empty())
         return fields;
-    }
     size_t pos = request->getBodyRef().find(boundary, 0);
     while (pos != std::string::npos && pos < request->getBodyRef().size()) {
         size_t position_content_disposition = request->getBodyRef().find("Content-Disposition: form-data",
@@ -205,27 +203,43 @@ onyxup::utils::parseRangesRequest(const std::string &src, size_t length) {
 }
 
 void onyxup::utils::parseParamsRequest(onyxup::PtrRequest request, size_t uri_len) {
-    const char *full_uri = request->getFullURIRef().c_str();
-    char *start_params_part = const_cast<char *>(strchr(full_uri, '?'));
-    if (start_params_part) {
-        request->setURI(std::string(full_uri, start_params_part - full_uri));
-        size_t buf_params_len = uri_len - (start_params_part - full_uri);
-        char *buf_params = new(std::nothrow) char[buf_params_len];
-        if (buf_params) {
-            memcpy(buf_params, start_params_part + 1, buf_params_len);
-            char *save_ptr;
-            char *token = strtok_r(buf_params, "&", &save_ptr);
-            while (token != NULL) {
-                char *sep = strchr(token, '=');
-                if (sep) {
-                    std::string key(token, sep - token);
-                    std::string value(sep + 1, strlen(token) - (sep - token) - 1);
-                    request->addParam(key, value);
-                }
-                token = strtok_r(NULL, "&", &save_ptr);
-            }
-            delete[] buf_params;
+    std::string_view full_uri = request->getFullURIRef().substr(0, uri_len);
+    size_t start_params_part = full_uri.find('?');
+    if (start_params_part != std::string_view::npos) {
+        /*
+         * URI без строки запроса - view на начало полного URI, без копирования
+         */
+        request->setURI(full_uri.substr(0, start_params_part));
+        std::string_view params = full_uri.substr(start_params_part + 1);
+        while (!params.empty()) {
+            size_t end = params.find('&');
+            std::string_view token = params.substr(0, end);
+            size_t sep = token.find('=');
+            if (sep != std::string_view::npos)
+                request->addParam(std::string(token.substr(0, sep)), std::string(token.substr(sep + 1)));
+            if (end == std::string_view::npos)
+                break;
+            params.remove_prefix(end + 1);
         }
     } else
-        request->setURI(request->getFullURIRef());
+        request->setURI(full_uri);
+}
+
+bool onyxup::utils::matchETag(std::string_view list, std::string_view etag) {
+    while (!list.empty()) {
+        size_t end = list.find(',');
+        std::string_view item = list.substr(0, end);
+        list = end == std::string_view::npos ? std::string_view() : list.substr(end + 1);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t'))
+            item.remove_prefix(1);
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t'))
+            item.remove_suffix(1);
+        if (item == "*")
+            return true;
+        if (item.compare(0, 2, "W/") == 0)
+            item.remove_prefix(2);
+        if (item == etag)
+            return true;
+    }
+    return false;
 }
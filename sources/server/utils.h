@@ -16,5 +16,9 @@ namespace onyxup {
         std::unordered_map<std::string, MultipartFormDataObject> multipartFormData(PtrCRequest request);
         std::vector<std::pair<size_t , size_t>> parseRangesRequest(const std::string & src, size_t length);
         void parseParamsRequest(onyxup::PtrRequest request, size_t uri_len);
+        /*
+         * Проверяет, есть ли etag в списке заголовка If-None-Match (слабое сравнение, "*" совпадает с любым)
+         */
+        bool matchETag(std::string_view list, std::string_view etag);
     }
 }
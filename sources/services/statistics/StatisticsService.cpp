@@ -81,10 +81,7 @@ void onyxup::StatisticsService::addTotalNumberClientRequests() {
     totalNumberClientRequests++;
 }
 
-onyxup::StatisticsService::StatisticsService(const PtrBuffer *buffers, const PtrRequest *requests, size_t n) {
-    buffersAndRequestsLength = n;
-    this->buffers = buffers;
-    this->requests = requests;
+onyxup::StatisticsService::StatisticsService() {
     totalNumberConnectionsAccepted = 0;
     totalNumberConnectionsProcessed = 0;
     totalNumberClientRequests = 0;
@@ -94,31 +91,41 @@ onyxup::StatisticsService::StatisticsService(const PtrBuffer *buffers, const Ptr
     currentNumberTasks = 0;
 }
 
+void onyxup::StatisticsService::addConnectionsTable(const PtrBuffer *buffers, const PtrRequest *requests, size_t n) {
+    tables.push_back({buffers, requests, n});
+}
+
 void onyxup::StatisticsService::computeCurrentNumberReadRequests() {
     currentNumberReadRequests = 0;
-    for (size_t i = 0; i < buffersAndRequestsLength; i++) {
-        if (requests[i] && buffers[i]) {
-            if (!requests[i]->isHeaderAccept() && buffers[i]->getPosInputBuffer() > 0)
-                currentNumberReadRequests++;
+    for (auto &table : tables) {
+        for (size_t i = 0; i < table.length; i++) {
+            if (table.requests[i] && table.buffers[i]) {
+                if (!table.requests[i]->isHeaderAccept() && table.buffers[i]->getPosInputBuffer() > 0)
+                    currentNumberReadRequests++;
+            }
         }
     }
 }
 
 void onyxup::StatisticsService::computeCurrentNumberWriteRequests() {
     currentNumberWriteRequests = 0;
-    for (size_t i = 0; i < buffersAndRequestsLength; i++) {
-        if (requests[i] && buffers[i]) {
-            if (requests[i]->isHeaderAccept() && buffers[i]->getPosOutputBuffer() > 0)
-                currentNumberWriteRequests++;
+    for (auto &table : tables) {
+        for (size_t i = 0; i < table.length; i++) {
+            if (table.requests[i] && table.buffers[i]) {
+                if (table.requests[i]->isHeaderAccept() && table.buffers[i]->getBytesToSend() > 0)
+                    currentNumberWriteRequests++;
+            }
         }
     }
 }
 
 void onyxup::StatisticsService::computeCurrentNumberWaitRequests() {
     currentNumberWaitRequests = 0;
-    for (size_t i = 0; i < buffersAndRequestsLength; i++) {
-        if (requests[i])
-            currentNumberWaitRequests++;
+    for (auto &table : tables) {
+        for (size_t i = 0; i < table.length; i++) {
+            if (table.requests[i])
+                currentNumberWaitRequests++;
+        }
     }
     currentNumberWaitRequests =
             currentNumberWaitRequests - currentNumberReadRequests - currentNumberWriteRequests;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <sstream>
+#include <vector>
+#include <atomic>
 
 #include "../../response/response-html.h"
 #include "../../response/response-base.h"
@@ -13,9 +15,9 @@
 namespace onyxup {
     class StatisticsService {
     private:
-        unsigned long long totalNumberConnectionsAccepted;
-        unsigned long long totalNumberConnectionsProcessed;
-        unsigned long long totalNumberClientRequests;
+        std::atomic<unsigned long long> totalNumberConnectionsAccepted;
+        std::atomic<unsigned long long> totalNumberConnectionsProcessed;
+        std::atomic<unsigned long long> totalNumberClientRequests;
 
         unsigned long long currentNumberReadRequests;
         unsigned long long currentNumberWriteRequests;
@@ -23,14 +25,23 @@ namespace onyxup {
 
         unsigned long long currentNumberTasks;
 
-        const PtrBuffer * buffers;
-        const PtrRequest * requests;
-        size_t buffersAndRequestsLength;
+        /*
+         * Таблицы соединений реакторов
+         */
+        struct ConnectionsTable {
+            const PtrBuffer * buffers;
+            const PtrRequest * requests;
+            size_t length;
+        };
+
+        std::vector<ConnectionsTable> tables;
 
     public:
         onyxup::ResponseBase callback(PtrCRequest);
 
-        StatisticsService(const PtrBuffer * buffers, const PtrRequest * requests, size_t n);
+        StatisticsService();
+
+        void addConnectionsTable(const PtrBuffer * buffers, const PtrRequest * requests, size_t n);
 
         void addTotalNumberConnectionsAccepted();
         void addTotalNumberConnectionsProcessed();
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <functional>
+
+#include "static-file-cache.h"
+
+bool onyxup::StaticFileCache::makeKey(const std::string &root, std::string_view relative, std::string &key) {
+    key.clear();
+    key.reserve(root.size() + relative.size());
+    key.append(root);
+    size_t pos = 0;
+    while (pos < relative.size()) {
+        size_t end = relative.find('/', pos);
+        if (end == std::string_view::npos)
+            end = relative.size();
+        std::string_view segment = relative.substr(pos, end - pos);
+        pos = end + 1;
+        if (segment.empty() || segment == ".")
+            continue;
+        if (segment == "..")
+            return false;
+        key.push_back('/');
+        key.append(segment.data(), segment.size());
+    }
+    /*
+     * Завершающий '/' сохраняется: такой путь указывает на каталог, а не на файл
+     */
+    if (!relative.empty() && relative.back() == '/')
+        key.push_back('/');
+    return true;
+}
+
+size_t onyxup::StaticFileCache::generationSlot(const std::string &path) {
+    return std::hash<std::string>()(path) % GENERATION_SLOTS;
+}
+
+void onyxup::StaticFileCache::evict() {
+    while (!entries.empty() && (currentSize > maxSize || entries.size() > maxFiles)) {
+        Entry &entry = entries.back();
+        currentSize -= entry.file->getSize();
+        index.erase(entry.path);
+        entries.pop_back();
+    }
+}
+
+onyxup::PtrStaticFile onyxup::StaticFileCache::find(const std::string &key, const std::string &sourceETag, size_t slot,
+                                                    unsigned long long &generation) {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation = generations[slot];
+    auto it = index.find(key);
+    if (it == index.end() || it->second->sourceETag != sourceETag)
+        return nullptr;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->file;
+}
+
+onyxup::PtrStaticFile onyxup::StaticFileCache::insert(const std::string &key, const PtrStaticFile &file,
+                                                      const std::string &sourceETag, size_t slot,
+                                                      unsigned long long generation) {
+    if (!file->isInMemory())
+        return file;
+    std::lock_guard<std::mutex> lock(mutex);
+    /*
+     * Путь обновили, пока файл открывался: файл мог быть открыт до замены, его запись устарела бы навсегда
+     */
+    if (generations[slot] != generation)
+        return file;
+    auto it = index.find(key);
+    /*
+     * Другой поток успел добавить актуальный файл - отдаем его, устаревший заменяем
+     */
+    if (it != index.end() && it->second->sourceETag == sourceETag && it->second->file->getETag() == file->getETag())
+        return it->second->file;
+    remove(key);
+    if (file->getSize() > maxSize)
+        return file;
+    entries.push_front(Entry{key, file, sourceETag});
+    index.emplace(key, entries.begin());
+    currentSize += file->getSize();
+    evict();
+    return file;
+}
+
+onyxup::PtrStaticFile onyxup::StaticFileCache::get(const std::string &path) {
+    size_t slot = generationSlot(path);
+    unsigned long long generation;
+    PtrStaticFile file = find(path, std::string(), slot, generation);
+    if (file != nullptr)
+        return file;
+    /*
+     * Файл открывается и отображается без блокировки, чтобы не задерживать остальные потоки
+     */
+    file = StaticFile::open(path, getMaxSize());
+    if (file == nullptr)
+        return nullptr;
+    return insert(path, file, std::string(), slot, generation);
+}
+
+static std::string variantKey(const std::string &path) {
+    /*
+     * Нулевой байт не встречается в путях, поэтому ключ варианта не совпадет с путем файла
+     */
+    std::string key(path);
+    key.push_back('\0');
+    key.append("gzip");
+    return key;
+}
+
+onyxup::PtrStaticFile onyxup::StaticFileCache::getCompressed(const std::string &path, const PtrStaticFile &source) {
+    std::string key = variantKey(path);
+    size_t slot = generationSlot(path);
+    unsigned long long generation;
+    PtrStaticFile variant = find(key, source->getETag(), slot, generation);
+    if (variant != nullptr)
+        return variant;
+    /*
+     * Вариант сжимается один раз и дальше отдается из кеша - максимальная степень сжатия окупается.
+     * Файл больше бюджета кеша не сохранится и будет сжиматься на каждый запрос
+     */
+    size_t max_size = getMaxSize();
+    int level = source->getSize() <= max_size ? Z_BEST_COMPRESSION : Z_DEFAULT_COMPRESSION;
+    variant = StaticFile::openCompressed(path, *source, max_size, level);
+    if (variant == nullptr)
+        return nullptr;
+    return insert(key, variant, source->getETag(), slot, generation);
+}
+
+size_t onyxup::StaticFileCache::getMaxSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return maxSize;
+}
+
+bool onyxup::StaticFileCache::remove(const std::string &key) {
+    auto it = index.find(key);
+    if (it == index.end())
+        return false;
+    currentSize -= it->second->file->getSize();
+    entries.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+void onyxup::StaticFileCache::refresh(const std::string &path) {
+    bool had_file;
+    bool had_variant;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        generations[generationSlot(path)]++;
+        had_file = remove(path);
+        had_variant = remove(variantKey(path));
+    }
+    if (!had_file && !had_variant)
+        return;
+    PtrStaticFile file = get(path);
+    if (file != nullptr && had_variant)
+        getCompressed(path, file);
+}
+
+void onyxup::StaticFileCache::refreshPrefix(const std::string &prefix) {
+    std::vector<std::string> paths;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        /*
+         * Под prefix могут открываться и еще не закешированные файлы - устаревают все поколения
+         */
+        for (unsigned long long &generation : generations)
+            generation++;
+        for (const Entry &entry : entries) {
+            if (entry.path.compare(0, prefix.size(), prefix) == 0)
+                paths.push_back(entry.path.substr(0, entry.path.find('\0')));
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    for (const std::string &path : paths)
+        refresh(path);
+}
+
+void onyxup::StaticFileCache::setMaxSize(size_t size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxSize = size;
+    evict();
+}
+
+void onyxup::StaticFileCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    entries.clear();
+    currentSize = 0;
+}
+
+size_t onyxup::StaticFileCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+size_t onyxup::StaticFileCache::getCurrentSize() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return currentSize;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <stddef.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "static-file.h"
+
+namespace onyxup {
+
+    /*
+     * Кеш статических ресурсов: файлы отображаются в память и хранятся по пути, повторный запрос
+     * не делает ни open, ни fstat и получает ссылку на то же отображение.
+     * Суммарный размер отображенных файлов ограничен maxSize байт, число файлов - maxFiles,
+     * при превышении вытесняются давно не запрашивавшиеся (LRU). Файлы больше maxSize
+     * не кешируются: они открываются на время ответа и отправляются через sendfile.
+     * Вытесненное отображение освобождается, когда его отпустит последняя задача, поэтому
+     * на короткое время занятая память может превышать maxSize.
+     * Сжатые варианты файлов хранятся в том же кеше по ключу (путь, кодирование) и учитываются в maxSize.
+     * Потокобезопасен - используется всеми рабочими потоками
+     */
+    class StaticFileCache {
+    private:
+        struct Entry {
+            std::string path;
+            PtrStaticFile file;
+            /*
+             * ETag файла, из которого получен сжатый вариант, для файла пусто
+             */
+            std::string sourceETag;
+        };
+        /*
+         * В начале списка - последние запрошенные файлы
+         */
+        std::list<Entry> entries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        mutable std::mutex mutex;
+        size_t maxSize;
+        size_t maxFiles;
+        size_t currentSize = 0;
+        /*
+         * Поколения путей: refresh увеличивает поколение своего пути. Файл открывается без блокировки,
+         * и если за это время путь обновили, открытый файл мог оказаться прежним - он отдается,
+         * но в кеш не попадает. Счетчики общие для путей с одинаковым хешем, чтобы их число
+         * не росло с числом файлов: совпадение лишь пропускает одну вставку
+         */
+        static constexpr size_t GENERATION_SLOTS = 64;
+        unsigned long long generations[GENERATION_SLOTS] = {};
+
+        static size_t generationSlot(const std::string & path);
+
+        void evict();
+
+        /*
+         * Поиск и вставка выполняются под блокировкой. Находятся только записи, полученные из файла
+         * с ETag sourceETag. Поиск запоминает в generation поколение пути, вставка не кеширует файл,
+         * если поколение с тех пор изменилось. Вставка возвращает уже закешированный файл,
+         * если его успел добавить другой поток
+         */
+        PtrStaticFile find(const std::string & key, const std::string & sourceETag, size_t slot,
+                           unsigned long long & generation);
+
+        PtrStaticFile insert(const std::string & key, const PtrStaticFile & file, const std::string & sourceETag,
+                             size_t slot, unsigned long long generation);
+
+        /*
+         * Вызывается под блокировкой, возвращает false, если записи не было
+         */
+        bool remove(const std::string & key);
+    public:
+
+        explicit StaticFileCache(size_t maxSize = 256 * 1024 * 1024, size_t maxFiles = 4096) : maxSize(maxSize), maxFiles(maxFiles) {
+        }
+
+        /*
+         * Ключ кеша (он же путь к файлу) для relative - пути от каталога root, начинающегося с '/'.
+         * Повторные '/' схлопываются, сегменты "." отбрасываются, так что разные записи одного URI
+         * попадают в одну запись кеша. Возвращает false, если сегмент ".." выводит путь за root
+         */
+        static bool makeKey(const std::string & root, std::string_view relative, std::string & key);
+
+        /*
+         * Возвращает файл из кеша или открывает и запоминает его. nullptr, если файла нет
+         */
+        PtrStaticFile get(const std::string & path);
+
+        /*
+         * Возвращает сжатый gzip вариант файла source, расположенного по path (StaticFile::openCompressed).
+         * Вариант ищется или сжимается один раз, пока source не изменится. nullptr, если файл не удалось прочитать
+         */
+        PtrStaticFile getCompressed(const std::string & path, const PtrStaticFile & source);
+
+        /*
+         * Файл по path изменился на диске: его запись и сжатый вариант удаляются и, если они были
+         * в кеше и файл существует, открываются (и сжимаются) заново, чтобы кеш оставался прогретым
+         */
+        void refresh(const std::string & path);
+
+        /*
+         * refresh для всех закешированных файлов, путь которых начинается с prefix. Файлы, которые
+         * открываются в этот момент, в кеш не попадут, даже если их еще не было в кеше
+         */
+        void refreshPrefix(const std::string & prefix);
+
+        /*
+         * Меняет ограничение на суммарный размер файлов, лишние файлы вытесняются сразу
+         */
+        void setMaxSize(size_t size);
+
+        size_t getMaxSize() const;
+
+        /*
+         * Наибольшее число записей: файлы и их сжатые варианты
+         */
+        inline size_t getMaxFiles() const {
+            return maxFiles;
+        }
+
+        void clear();
+
+        size_t size() const;
+
+        /*
+         * Суммарный размер закешированных файлов в байтах
+         */
+        size_t getCurrentSize() const;
+    };
+}
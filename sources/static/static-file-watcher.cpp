@@ -0,0 +1,188 @@
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "static-file-watcher.h"
+#include "../plog/Log.h"
+
+/*
+ * IN_CLOSE_WRITE, а не IN_MODIFY: файл перечитывается, когда запись закончена
+ */
+static const uint32_t DIRECTORY_EVENTS = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE |
+                                         IN_ATTRIB | IN_ONLYDIR;
+static const uint32_t PARENT_EVENTS = IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR;
+
+static bool isDirectory(const std::string &path, const struct dirent *entry) {
+    if (entry->d_type != DT_UNKNOWN)
+        return entry->d_type == DT_DIR;
+    struct stat st;
+    return lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+onyxup::StaticFileWatcher::StaticFileWatcher(StaticFileCache &cache, const std::string &root) : cache(cache), root(root) {
+}
+
+bool onyxup::StaticFileWatcher::start() {
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1) {
+        LOGE << "Не возможно создать inotify, кеш статических ресурсов не будет обновляться. Ошибка " << errno;
+        return false;
+    }
+    stopFd = eventfd(0, EFD_CLOEXEC);
+    if (stopFd == -1) {
+        LOGE << "Не возможно создать eventfd, кеш статических ресурсов не будет обновляться. Ошибка " << errno;
+        return false;
+    }
+    /*
+     * Родительский каталог нужен, чтобы заметить замену самого root
+     */
+    std::string path = root;
+    while (path.size() > 1 && path.back() == '/')
+        path.pop_back();
+    size_t slash = path.rfind('/');
+    std::string parent = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    rootName = slash == std::string::npos ? path : path.substr(slash + 1);
+    parentWatch = inotify_add_watch(inotifyFd, parent.c_str(), PARENT_EVENTS);
+    addWatches("");
+    if (directories.empty()) {
+        LOGE << "Не возможно следить за каталогом статических ресурсов " << root;
+        return false;
+    }
+    thread = std::thread(&StaticFileWatcher::run, this);
+    return true;
+}
+
+onyxup::StaticFileWatcher::~StaticFileWatcher() {
+    if (thread.joinable()) {
+        uint64_t value = 1;
+        if (write(stopFd, &value, sizeof(value)) == sizeof(value))
+            thread.join();
+        else
+            thread.detach();
+    }
+    if (stopFd != -1)
+        close(stopFd);
+    if (inotifyFd != -1)
+        close(inotifyFd);
+}
+
+void onyxup::StaticFileWatcher::addWatches(const std::string &relative) {
+    std::string path = root + relative;
+    int wd = inotify_add_watch(inotifyFd, path.c_str(), DIRECTORY_EVENTS);
+    if (wd == -1) {
+        LOGE << "Не возможно следить за каталогом " << path << ". Ошибка " << errno;
+        return;
+    }
+    directories[wd] = relative;
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr)
+        return;
+    while (struct dirent *entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+            continue;
+        std::string child = relative + "/" + entry->d_name;
+        if (isDirectory(root + child, entry))
+            addWatches(child);
+    }
+    closedir(dir);
+}
+
+void onyxup::StaticFileWatcher::removeWatches(const std::string &relative) {
+    for (auto it = directories.begin(); it != directories.end();) {
+        const std::string &directory = it->second;
+        if (directory.compare(0, relative.size(), relative) == 0 &&
+            (directory.size() == relative.size() || directory[relative.size()] == '/')) {
+            inotify_rm_watch(inotifyFd, it->first);
+            it = directories.erase(it);
+        } else
+            ++it;
+    }
+}
+
+void onyxup::StaticFileWatcher::resetWatches() {
+    for (auto &directory : directories)
+        inotify_rm_watch(inotifyFd, directory.first);
+    directories.clear();
+    addWatches("");
+}
+
+void onyxup::StaticFileWatcher::processEvent(const struct inotify_event *event) {
+    /*
+     * События потеряны - перечитываем все
+     */
+    if (event->mask & IN_Q_OVERFLOW) {
+        LOGI << "Переполнена очередь inotify, кеш статических ресурсов перечитывается целиком";
+        cache.refreshPrefix(root);
+        return;
+    }
+    if (event->wd == parentWatch) {
+        if (event->len > 0 && rootName == event->name) {
+            LOGI << "Каталог статических ресурсов " << root << " заменен, кеш перечитывается";
+            resetWatches();
+            cache.refreshPrefix(root);
+        }
+        return;
+    }
+    auto it = directories.find(event->wd);
+    if (it == directories.end())
+        return;
+    if (event->mask & IN_IGNORED) {
+        directories.erase(it);
+        return;
+    }
+    if (event->len == 0)
+        return;
+    std::string relative = it->second + "/" + event->name;
+    std::string path;
+    if (!StaticFileCache::makeKey(root, relative, path))
+        return;
+    if (event->mask & IN_ISDIR) {
+        if (event->mask & (IN_MOVED_FROM | IN_DELETE))
+            removeWatches(relative);
+        if (event->mask & (IN_CREATE | IN_MOVED_TO))
+            addWatches(relative);
+        cache.refreshPrefix(path + "/");
+        return;
+    }
+    /*
+     * Готовый файл .gz - это сжатый вариант файла без расширения .gz
+     */
+    if (path.size() > 3 && path.compare(path.size() - 3, 3, ".gz") == 0)
+        cache.refresh(path.substr(0, path.size() - 3));
+    cache.refresh(path);
+}
+
+void onyxup::StaticFileWatcher::run() {
+    alignas(struct inotify_event) char buffer[4096];
+    struct pollfd fds[2];
+    fds[0].fd = inotifyFd;
+    fds[0].events = POLLIN;
+    fds[1].fd = stopFd;
+    fds[1].events = POLLIN;
+    for (;;) {
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR)
+                continue;
+            LOGE << "Ошибка ожидания событий inotify " << errno;
+            return;
+        }
+        if (fds[1].revents & POLLIN)
+            return;
+        for (;;) {
+            ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0)
+                break;
+            for (char *ptr = buffer; ptr < buffer + length;) {
+                const struct inotify_event *event = (const struct inotify_event *) ptr;
+                processEvent(event);
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "static-file-cache.h"
+
+struct inotify_event;
+
+namespace onyxup {
+
+    /*
+     * Следит через inotify за каталогом статических ресурсов и его подкаталогами и в фоновом потоке
+     * обновляет в кеше ровно те файлы, которые изменились (StaticFileCache::refresh).
+     * Замена всего каталога (mv или ln -sfn на месте root) отслеживается по родительскому каталогу:
+     * тогда перечитываются все закешированные файлы, а наблюдение переносится на новое дерево.
+     * Ключи кеша строятся так же, как в HttpServer::defaultStaticResourcesCallback: StaticFileCache::makeKey
+     */
+    class StaticFileWatcher {
+    private:
+        StaticFileCache & cache;
+        std::string root;
+        std::string rootName;
+        int inotifyFd = -1;
+        int stopFd = -1;
+        int parentWatch = -1;
+        /*
+         * Дескриптор наблюдения -> путь каталога относительно root ("" для самого root, "/static" ...)
+         */
+        std::unordered_map<int, std::string> directories;
+        std::thread thread;
+
+        void addWatches(const std::string & relative);
+
+        void removeWatches(const std::string & relative);
+
+        void resetWatches();
+
+        void processEvent(const struct inotify_event * event);
+
+        void run();
+    public:
+
+        StaticFileWatcher(StaticFileCache & cache, const std::string & root);
+
+        StaticFileWatcher(const StaticFileWatcher &) = delete;
+        StaticFileWatcher & operator=(const StaticFileWatcher &) = delete;
+
+        /*
+         * Ставит наблюдение и запускает поток. Возвращает false, если inotify недоступен
+         */
+        bool start();
+
+        ~StaticFileWatcher();
+    };
+}
@@ -0,0 +1,183 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+
+#include "static-file.h"
+#include "../response/http-date.h"
+#include "../gzip/compress.hpp"
+
+/*
+ * Пустой файл не отображается, но считается отображенным
+ */
+static const char EMPTY_FILE_DATA[1] = {'\0'};
+
+/*
+ * Файл, усеченный или перезаписанный на месте после отображения, при чтении отображения
+ * за новым концом дает SIGBUS. Чтение отображения из пользовательского кода выполняется
+ * только через copyMapped: на время копирования поток выставляет точку возврата,
+ * и обработчик SIGBUS возвращает в нее вместо завершения процесса.
+ * Отправка отображения через sendmsg сигнала не вызывает - ядро возвращает EFAULT
+ */
+static thread_local sigjmp_buf *mappingGuard = nullptr;
+
+static struct sigaction previousSigbusAction;
+
+static void handleSigbus(int, siginfo_t *, void *) {
+    if (mappingGuard != nullptr)
+        siglongjmp(*mappingGuard, 1);
+    /*
+     * Ошибка не при копировании отображения - возвращаем прежний обработчик,
+     * повторное обращение к памяти вызовет его
+     */
+    sigaction(SIGBUS, &previousSigbusAction, nullptr);
+}
+
+static void installSigbusHandler() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_sigaction = handleSigbus;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGBUS, &action, &previousSigbusAction);
+    });
+}
+
+/*
+ * Копирует n байт отображения файла. Возвращает false, если файл стал короче отображения
+ */
+static bool copyMapped(char *dst, const char *src, size_t n) {
+    sigjmp_buf guard;
+    if (sigsetjmp(guard, 1) != 0) {
+        mappingGuard = nullptr;
+        return false;
+    }
+    mappingGuard = &guard;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    memcpy(dst, src, n);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    mappingGuard = nullptr;
+    return true;
+}
+
+onyxup::StaticFile::StaticFile(int fd, const char *data, const struct stat &st) : fd(fd), data(data),
+                                                                                    size((size_t) st.st_size),
+                                                                                    mtime(st.st_mtime) {
+    char buffer[64];
+    unsigned long long mtime_ns = (unsigned long long) st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec;
+    int length = snprintf(buffer, sizeof(buffer), "\"%llx-%llx-%llx\"", (unsigned long long) size, mtime_ns,
+                          (unsigned long long) st.st_ino);
+    etag.assign(buffer, length);
+    lastModified.resize(HttpDate::LENGTH);
+    HttpDate::format(mtime, &lastModified[0]);
+}
+
+onyxup::StaticFile::StaticFile(std::string content, std::string etag, const StaticFile &source) : fd(-1),
+                                                                                                  content(std::move(content)),
+                                                                                                  etag(std::move(etag)),
+                                                                                                  lastModified(source.lastModified) {
+    data = this->content.data();
+    size = this->content.size();
+    mtime = source.mtime;
+}
+
+onyxup::PtrStaticFile onyxup::StaticFile::open(const std::string &path, size_t maxMappedSize) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = (size_t) st.st_size;
+    if (size > maxMappedSize)
+        return PtrStaticFile(new StaticFile(fd, nullptr, st));
+    const char *data = EMPTY_FILE_DATA;
+    if (size > 0) {
+        installSigbusHandler();
+        void *addr = mmap(nullptr, size, PROT_READ, MAP_SHARED | MAP_POPULATE, fd, 0);
+        /*
+         * Не удалось отобразить - отправляем через sendfile
+         */
+        if (addr == MAP_FAILED)
+            return PtrStaticFile(new StaticFile(fd, nullptr, st));
+        data = (const char *) addr;
+    }
+    close(fd);
+    return PtrStaticFile(new StaticFile(-1, data, st));
+}
+
+onyxup::PtrStaticFile onyxup::StaticFile::compress(const StaticFile &source, int level) {
+    std::string compressed;
+    if (!source.content.empty())
+        compressed = gzip::compress(source.data, source.size, level);
+    else {
+        /*
+         * Отображение сжимается через копию: zlib не должен читать файл, который могут усечь
+         */
+        std::string buffer;
+        if (!source.read(0, source.size, buffer))
+            return nullptr;
+        compressed = gzip::compress(buffer.data(), buffer.size(), level);
+    }
+    return PtrStaticFile(new StaticFile(std::move(compressed), variantETag(source.etag, "gzip"), source));
+}
+
+onyxup::PtrStaticFile onyxup::StaticFile::openCompressed(const std::string &path, const StaticFile &source,
+                                                        size_t maxMappedSize, int level) {
+    PtrStaticFile file = open(path + ".gz", maxMappedSize);
+    if (file != nullptr && file->mtime >= source.mtime)
+        return file;
+    return compress(source, level);
+}
+
+std::string onyxup::StaticFile::variantETag(const std::string &etag, const char *encoding) {
+    std::string variant(etag, 0, etag.size() - 1);
+    variant.append("-").append(encoding).append("\"");
+    return variant;
+}
+
+onyxup::StaticFile::~StaticFile() {
+    if (content.empty() && data != nullptr && size > 0)
+        munmap((void *) data, size);
+    if (fd != -1)
+        close(fd);
+}
+
+bool onyxup::StaticFile::read(size_t offset, size_t length, std::string &out) const {
+    if (data != nullptr && !content.empty()) {
+        out.assign(data + offset, length);
+        return true;
+    }
+    if (data != nullptr) {
+        out.resize(length);
+        if (length > 0 && !copyMapped(&out[0], data + offset, length)) {
+            out.clear();
+            return false;
+        }
+        return true;
+    }
+    out.resize(length);
+    size_t done = 0;
+    while (done < length) {
+        ssize_t res = pread(fd, &out[done], length - done, offset + done);
+        if (res == -1 && errno == EINTR)
+            continue;
+        if (res <= 0) {
+            out.resize(done);
+            return false;
+        }
+        done += res;
+    }
+    return true;
+}
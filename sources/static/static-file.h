@@ -0,0 +1,133 @@
+#pragma once
+
+#include <stddef.h>
+#include <time.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+
+#include "../gzip/config.hpp"
+#include <zlib.h>
+
+namespace onyxup {
+
+    class StaticFile;
+
+    using PtrStaticFile = std::shared_ptr<const StaticFile>;
+
+    /*
+     * Файл статического ресурса. Размер и время изменения берутся из fstat при открытии.
+     * Файл либо открыт (тело отправляется через sendfile), либо целиком отображен в память
+     * (тело отправляется через sendmsg прямо из отображения, дескриптор уже закрыт).
+     * Сжатый вариант файла хранит содержимое в собственной строке и отправляется так же, как отображенный.
+     * Ресурсы освобождаются вместе с последней ссылкой: задача, ожидающая отправки,
+     * держит файл, даже если он уже вытеснен из кеша.
+     * Обновлять ресурсы нужно через rename: если отображенный файл усечь или перезаписать на месте,
+     * read и compress вернут ошибку вместо завершения процесса по SIGBUS, но клиенты могут получить
+     * смесь старого и нового содержимого, а отправка из усеченного отображения закрывает соединение
+     */
+    class StaticFile {
+    private:
+        int fd;
+        const char * data;
+        size_t size;
+        /*
+         * Содержимое сжатого варианта, для файла пусто
+         */
+        std::string content;
+        time_t mtime;
+        /*
+         * Значения заголовков ETag и Last-Modified, вычисляются один раз при открытии
+         */
+        std::string etag;
+        std::string lastModified;
+
+        StaticFile(int fd, const char * data, const struct stat & st);
+
+        StaticFile(std::string content, std::string etag, const StaticFile & source);
+    public:
+
+        /*
+         * Открывает обычный файл на чтение, файл не больше maxMappedSize байт отображается в память
+         * целиком, страницы подгружаются сразу, чтобы реактор не ждал диск при отправке.
+         * Возвращает nullptr, если файла нет или это не обычный файл
+         */
+        static PtrStaticFile open(const std::string & path, size_t maxMappedSize = 0);
+
+        /*
+         * Сжимает source в gzip со степенью level. Максимальная степень (Z_BEST_COMPRESSION) окупается только
+         * для варианта, который сохраняется в кеше. ETag варианта получается из ETag исходного файла
+         * (variantETag), Last-Modified - тот же
+         */
+        static PtrStaticFile compress(const StaticFile & source, int level = Z_DEFAULT_COMPRESSION);
+
+        /*
+         * Сжатый gzip вариант файла source, расположенного по path: готовый файл path.gz, если он есть
+         * и не старше source, иначе результат compress с level. nullptr, если файл не удалось прочитать
+         */
+        static PtrStaticFile openCompressed(const std::string & path, const StaticFile & source, size_t maxMappedSize = 0,
+                                            int level = Z_DEFAULT_COMPRESSION);
+
+        /*
+         * ETag варианта файла с кодированием encoding: суффикс добавляется внутрь кавычек
+         */
+        static std::string variantETag(const std::string & etag, const char * encoding);
+
+        StaticFile(const StaticFile &) = delete;
+        StaticFile & operator=(const StaticFile &) = delete;
+
+        ~StaticFile();
+
+        inline int getFD() const {
+            return fd;
+        }
+
+        /*
+         * Содержимое доступно в памяти: файл отображен или это сжатый вариант
+         */
+        inline bool isInMemory() const {
+            return data != nullptr;
+        }
+
+        /*
+         * Содержимое в памяти, nullptr для неотображенного файла
+         */
+        inline const char * getData() const {
+            return data;
+        }
+
+        inline size_t getSize() const {
+            return size;
+        }
+
+        inline time_t getModificationTime() const {
+            return mtime;
+        }
+
+        /*
+         * Сильный ETag из размера, времени изменения (в наносекундах) и номера inode, в кавычках
+         */
+        inline const std::string & getETag() const {
+            return etag;
+        }
+
+        inline const std::string & getLastModified() const {
+            return lastModified;
+        }
+
+        /*
+         * Читает length байт с позиции offset в out. Возвращает false при ошибке чтения,
+         * в том числе если отображенный файл стал короче
+         */
+        bool read(size_t offset, size_t length, std::string & out) const;
+    };
+
+    /*
+     * Часть файла, которая отправляется как тело ответа
+     */
+    struct FileRange {
+        PtrStaticFile file;
+        size_t offset = 0;
+        size_t length = 0;
+    };
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <new>
+
+#include "task.h"
+
+namespace onyxup {
+
+    /*
+     * Пул задач реактора. Свободные задачи связаны в список по полю Task::next,
+     * каждая задача владеет своим Request, который переиспользуется вместе с ней.
+     * Не потокобезопасен: задачи берет и возвращает только поток своего реактора
+     */
+    class TaskPool {
+    private:
+        PtrTask head = nullptr;
+        size_t available = 0;
+        size_t maxAvailable;
+    public:
+
+        explicit TaskPool(size_t maxAvailable) : maxAvailable(maxAvailable) {
+        }
+
+        TaskPool(const TaskPool &) = delete;
+
+        ~TaskPool() {
+            while (head) {
+                PtrTask task = head;
+                head = task->getNext();
+                delete task;
+            }
+        }
+
+        /*
+         * Возвращает nullptr при ошибке выделения памяти
+         */
+        inline PtrTask acquire() {
+            if (head) {
+                PtrTask task = head;
+                head = task->getNext();
+                task->setNext(nullptr);
+                available--;
+                return task;
+            }
+            PtrTask task = taskFactory();
+            if (task == nullptr)
+                return nullptr;
+            task->setRequest(req::requestFactory());
+            if (task->getRequest() == nullptr) {
+                delete task;
+                return nullptr;
+            }
+            return task;
+        }
+
+        /*
+         * Задача очищается и возвращается в пул, сверх maxAvailable - удаляется
+         */
+        inline void release(PtrTask task) {
+            if (available >= maxAvailable) {
+                delete task;
+                return;
+            }
+            task->reset();
+            task->setNext(head);
+            head = task;
+            available++;
+        }
+
+        inline size_t size() const {
+            return available;
+        }
+    };
+}
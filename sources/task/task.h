@@ -1,14 +1,18 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 
 #include "../request/request.h"
 #include "../response/response-base.h"
+#include "../response/response-writer.h"
 
 namespace onyxup {
 
     class Task;
 
+    class Reactor;
+
     using PtrTask = Task*;
 
     enum class EnumTaskType {
@@ -23,21 +27,59 @@ namespace onyxup {
     private:
         int fd;
         onyxup::PtrRequest request;
-        std::function<ResponseBase(PtrCRequest request)> handler;
+        /*
+         * Обработчик маршрута, указывает в Router и не копируется
+         */
+        const std::function<ResponseBase(PtrCRequest request)> * handler = nullptr;
+        const ResponseWriterHandler * writerHandler = nullptr;
         EnumTaskType type;
-        std::string responseData;
-        std::chrono::time_point<std::chrono::steady_clock> timePoint;
+        /*
+         * Заголовок и тело ответа хранятся раздельно, тело переносится из ResponseBase без копирования
+         */
+        std::string responseHeader;
+        std::string responseBody;
+        /*
+         * Тело из файла, отправляется после заголовка и тела через sendfile
+         */
+        FileRange responseFile;
+        /*
+         * Заранее сформированный ответ реактора (CannedResponses), отправляется по ссылке
+         */
+        std::shared_ptr<const std::string> sharedHeader;
+        std::shared_ptr<const std::string> sharedBody;
+        unsigned long long connectionId;
         int code;
+        Reactor * reactor;
+        /*
+         * Ответ получен реактором и ждет отправки предыдущих ответов соединения
+         */
+        bool performed = false;
+        Task * next = nullptr;
+
+        /*
+         * Очищает буфер ответа, буфер больше MAX_RETAINED_BUFFER_LENGTH освобождается
+         */
+        static inline void releaseBuffer(std::string & buffer) {
+            if (buffer.capacity() > MAX_RETAINED_BUFFER_LENGTH)
+                std::string().swap(buffer);
+            else
+                buffer.clear();
+        }
     public:
 
+        /*
+         * Наибольший размер буферов запроса и ответа, который задача сохраняет при возврате в пул
+         */
+        static constexpr size_t MAX_RETAINED_BUFFER_LENGTH = 64 * 1024;
+
         Task() = default;
         
         ~Task(){
             delete request;
         }
 
-        inline void setTimePoint(std::chrono::time_point<std::chrono::steady_clock> & timePoint){
-            this->timePoint = timePoint;
+        inline void setConnectionId(unsigned long long id) {
+            connectionId = id;
         }
 
         inline void setFD(int fd) {
@@ -56,28 +98,67 @@ namespace onyxup {
             return fd;
         }
 
-        inline std::string getResponseData() const {
-            return responseData;
+        inline const std::string & getResponseHeader() const {
+            return sharedHeader ? *sharedHeader : responseHeader;
+        }
+
+        inline const std::string & getResponseBody() const {
+            return sharedBody ? *sharedBody : responseBody;
+        }
+        
+        inline const FileRange & getResponseFile() const {
+            return responseFile;
+        }
+
+        /*
+         * Полная длина ответа: заголовок, тело и часть файла
+         */
+        inline size_t getResponseLength() const {
+            return getResponseHeader().size() + getResponseBody().size() + responseFile.length;
         }
         
-        inline std::chrono::time_point<std::chrono::steady_clock> getTimePoint() const {
-            return timePoint;
+        inline unsigned long long getConnectionId() const {
+            return connectionId;
         }
         
-        void setHandler(const std::function<ResponseBase(PtrCRequest) > & handler) {
+        inline void setHandler(const std::function<ResponseBase(PtrCRequest) > * handler) {
             this->handler = handler;
         }
 
-        std::function<ResponseBase(PtrCRequest) > getHandler() {
-            return handler;
+        inline const std::function<ResponseBase(PtrCRequest) > & getHandler() const {
+            return *handler;
+        }
+
+        inline void setWriterHandler(const ResponseWriterHandler * handler) {
+            writerHandler = handler;
+        }
+
+        inline const ResponseWriterHandler * getWriterHandler() const {
+            return writerHandler;
+        }
+
+        /*
+         * Буфер для ResponseWriter: ответ записывается в него целиком, тело остается пустым.
+         * Память буфера сохраняется при возврате задачи в пул
+         */
+        inline std::string & getResponseBuffer() {
+            responseBody.clear();
+            return responseHeader;
         }
         
         inline onyxup::PtrRequest getRequest() const {
             return request;
         }
         
-        inline void setResponseData(std::string && data) {
-            responseData = data;
+        inline void setResponse(ResponseBase & response) {
+            response.release(responseHeader, responseBody, request->isClosingConnect());
+            responseFile = response.releaseFile();
+        }
+
+        inline void setSharedResponse(const std::shared_ptr<const std::string> & header,
+                                      const std::shared_ptr<const std::string> & body) {
+            sharedHeader = header;
+            sharedBody = body;
         }
 
         inline void setRequest(onyxup::PtrRequest request) {
@@ -92,6 +173,51 @@ namespace onyxup {
             return code;
         }
 
+        inline void setReactor(Reactor * reactor) {
+            this->reactor = reactor;
+        }
+
+        inline Reactor * getReactor() const {
+            return reactor;
+        }
+
+        inline bool isPerformed() const {
+            return performed;
+        }
+
+        inline void setPerformed(bool flag) {
+            performed = flag;
+        }
+
+        inline Task * getNext() const {
+            return next;
+        }
+
+        inline void setNext(Task * task) {
+            next = task;
+        }
+
+        /*
+         * Подготавливает задачу к повторному использованию, Request и память ответа сохраняются,
+         * если не превышают MAX_RETAINED_BUFFER_LENGTH. Иначе задача в пуле удерживала бы память
+         * самого большого запроса или ответа, прошедшего через нее
+         */
+        inline void reset() {
+            if (request) {
+                request->clear();
+                request->shrink(MAX_RETAINED_BUFFER_LENGTH);
+            }
+            handler = nullptr;
+            writerHandler = nullptr;
+            releaseBuffer(responseHeader);
+            releaseBuffer(responseBody);
+            responseFile = FileRange();
+            sharedHeader.reset();
+            sharedBody.reset();
+            performed = false;
+            next = nullptr;
+        }
+
     };
 
 }
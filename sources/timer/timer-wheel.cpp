@@ -0,0 +1,84 @@
+#include "timer-wheel.h"
+
+onyxup::TimerWheel::TimerWheel(size_t maxTimers, std::chrono::milliseconds tick, size_t numberSlots) :
+        tick(tick), start(Clock::now()), nodes(maxTimers), slots(numberSlots, nullptr) {
+}
+
+void onyxup::TimerWheel::link(Node *node, size_t slot) {
+    node->slot = slot;
+    node->prev = nullptr;
+    node->next = slots[slot];
+    if (slots[slot])
+        slots[slot]->prev = node;
+    slots[slot] = node;
+}
+
+void onyxup::TimerWheel::unlink(Node *node) {
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        slots[node->slot] = node->next;
+    if (node->next)
+        node->next->prev = node->prev;
+    node->prev = nullptr;
+    node->next = nullptr;
+}
+
+void onyxup::TimerWheel::arm(int id, TimePoint deadline) {
+    Node *node = &nodes[id];
+    if (node->armed)
+        unlink(node);
+    else
+        numberArmed++;
+    /*
+     * Номер ячейки округляем вверх, чтобы таймер не сработал раньше дедлайна.
+     * Просроченные таймеры ставим в ближайшую необработанную ячейку
+     */
+    size_t deadline_tick = currentTick;
+    if (deadline > start) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - start);
+        size_t t = (elapsed.count() + tick.count() - 1) / tick.count();
+        if (t > deadline_tick)
+            deadline_tick = t;
+    }
+    node->deadline = deadline;
+    node->armed = true;
+    link(node, deadline_tick % slots.size());
+}
+
+void onyxup::TimerWheel::cancel(int id) {
+    Node *node = &nodes[id];
+    if (!node->armed)
+        return;
+    unlink(node);
+    node->armed = false;
+    numberArmed--;
+}
+
+void onyxup::TimerWheel::expire(TimePoint now, std::vector<int> &expired) {
+    if (now < start)
+        return;
+    size_t now_tick = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count() / tick.count();
+    if (now_tick < currentTick)
+        return;
+    /*
+     * За один вызов каждую ячейку просматриваем не больше одного раза
+     */
+    size_t last_tick = now_tick;
+    if (last_tick - currentTick >= slots.size())
+        last_tick = currentTick + slots.size() - 1;
+    for (size_t t = currentTick; t <= last_tick && numberArmed > 0; t++) {
+        Node *node = slots[t % slots.size()];
+        while (node) {
+            Node *next = node->next;
+            if (node->deadline <= now) {
+                unlink(node);
+                node->armed = false;
+                numberArmed--;
+                expired.push_back((int) (node - nodes.data()));
+            }
+            node = next;
+        }
+    }
+    currentTick = now_tick + 1;
+}
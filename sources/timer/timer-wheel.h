@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+#include <chrono>
+
+namespace onyxup {
+
+    /*
+     * Хешированное колесо таймеров. Таймер задается идентификатором (fd соединения) от 0 до maxTimers - 1,
+     * у каждого идентификатора не больше одного таймера. Ячейка колеса - интервал tick, таймеры с
+     * дедлайном дальше одного оборота колеса остаются в ячейке до нужного оборота.
+     * Постановка и отмена - O(1), выборка истекших - O(истекших + пройденных ячеек).
+     * Не потокобезопасно - используется только потоком своего реактора
+     */
+    class TimerWheel {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+    private:
+        struct Node {
+            Node * prev = nullptr;
+            Node * next = nullptr;
+            TimePoint deadline;
+            size_t slot = 0;
+            bool armed = false;
+        };
+
+        std::chrono::milliseconds tick;
+        TimePoint start;
+        size_t currentTick = 0;
+        size_t numberArmed = 0;
+
+        std::vector<Node> nodes;
+        std::vector<Node *> slots;
+
+        void link(Node * node, size_t slot);
+
+        void unlink(Node * node);
+
+    public:
+
+        TimerWheel(size_t maxTimers, std::chrono::milliseconds tick = std::chrono::milliseconds(100),
+                   size_t numberSlots = 4096);
+
+        TimerWheel(const TimerWheel &) = delete;
+
+        /*
+         * Ставит (или переставляет) таймер id на момент deadline
+         */
+        void arm(int id, TimePoint deadline);
+
+        void cancel(int id);
+
+        inline bool isArmed(int id) const {
+            return nodes[id].armed;
+        }
+
+        inline TimePoint getDeadline(int id) const {
+            return nodes[id].deadline;
+        }
+
+        inline size_t size() const {
+            return numberArmed;
+        }
+
+        /*
+         * Снимает все таймеры с дедлайном не позже now и дописывает их идентификаторы в expired
+         */
+        void expire(TimePoint now, std::vector<int> & expired);
+    };
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+
+#include "../sources/buffer/buffer.h"
+
+class BufferPoolTests : public ::testing::Test {
+
+public:
+
+    BufferPoolTests() {
+    }
+
+    ~BufferPoolTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+    /*
+     * Размер выделенного входного буфера: занятая часть плюс свободная
+     */
+    static size_t getCapacity(onyxup::PtrBuffer buffer) {
+        return buffer->getPosInputBuffer() + buffer->reserveInputBuffer(0);
+    }
+
+};
+
+TEST_F(BufferPoolTests, Test_1) {
+    /*
+     * Размер блока округляется вверх до класса INITIAL_BUFFER_LENGTH * 2^i
+     */
+    const size_t initial = onyxup::BufferPool::INITIAL_BUFFER_LENGTH;
+    onyxup::BufferPool pool(1024 * 1024);
+    size_t sizes[][2] = {{1, initial}, {initial, initial}, {initial + 1, initial * 2},
+                         {initial * 3, initial * 4}, {100 * 1024, initial * 8}};
+    for (auto &size : sizes) {
+        size_t length = size[0];
+        char *chunk = pool.allocate(length);
+        ASSERT_NE(chunk, nullptr);
+        ASSERT_EQ(length, size[1]);
+        pool.deallocate(chunk, length);
+    }
+}
+TEST_F(BufferPoolTests, Test_2) {
+    /*
+     * Освобожденный блок выдается повторно только для своего класса
+     */
+    const size_t initial = onyxup::BufferPool::INITIAL_BUFFER_LENGTH;
+    onyxup::BufferPool pool(1024 * 1024);
+    size_t length = initial * 2;
+    char *chunk = pool.allocate(length);
+    pool.deallocate(chunk, length);
+    size_t small = 10;
+    char *other = pool.allocate(small);
+    ASSERT_NE(other, chunk);
+    size_t same = initial + 100;
+    ASSERT_EQ(pool.allocate(same), chunk);
+    ASSERT_EQ(same, initial * 2);
+    pool.deallocate(other, small);
+    pool.deallocate(chunk, same);
+}
+TEST_F(BufferPoolTests, Test_3) {
+    /*
+     * Буфер соединения выделяет память только при первом использовании, растет через классы
+     * с сохранением данных и возвращает выросший блок в пул при очистке
+     */
+    const size_t initial = onyxup::BufferPool::INITIAL_BUFFER_LENGTH;
+    onyxup::BufferPool pool(1024 * 1024);
+    onyxup::PtrBuffer buffer = pool.getBuffer();
+    ASSERT_NE(buffer, nullptr);
+    ASSERT_EQ(buffer->getInputBuffer(), nullptr);
+    ASSERT_EQ(buffer->reserveInputBuffer(100), initial);
+    std::string data;
+    for (size_t i = 0; i < initial * 8; i++)
+        data.push_back((char) ('a' + i % 26));
+    size_t pos = 0;
+    size_t capacities[] = {initial, initial * 2, initial * 4, initial * 8};
+    for (size_t capacity : capacities) {
+        ASSERT_TRUE(buffer->addDataToInputBuffer(data.data() + pos, capacity - pos));
+        pos = capacity;
+        ASSERT_EQ(getCapacity(buffer), capacity);
+    }
+    ASSERT_EQ(buffer->getPosInputBuffer(), initial * 8);
+    ASSERT_EQ(memcmp(buffer->getInputBuffer(), data.data(), data.size()), 0);
+    char *grown = buffer->getInputBuffer();
+    buffer->clear();
+    ASSERT_EQ(buffer->getInputBuffer(), nullptr);
+    /*
+     * Следующему соединению достается тот же блок, а не новый
+     */
+    size_t length = initial * 8;
+    ASSERT_EQ(pool.allocate(length), grown);
+    pool.deallocate(grown, length);
+    pool.releaseBuffer(buffer);
+}
+TEST_F(BufferPoolTests, Test_4) {
+    /*
+     * Путь чтения с переливом: заполняем свободную часть буфера, остаток прочитанного
+     * дописывается из временного буфера, и входной буфер переходит в больший класс
+     */
+    const size_t initial = onyxup::BufferPool::INITIAL_BUFFER_LENGTH;
+    onyxup::BufferPool pool(1024 * 1024);
+    onyxup::PtrBuffer buffer = pool.getBuffer();
+    std::string data(initial + 40 * 1024, '\0');
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (char) (i * 7);
+    size_t free = buffer->reserveInputBuffer(initial);
+    ASSERT_EQ(free, initial);
+    memcpy(buffer->getInputBufferTail(), data.data(), free);
+    buffer->commitInputBuffer(free);
+    char *first = buffer->getInputBuffer();
+    ASSERT_TRUE(buffer->addDataToInputBuffer(data.data() + free, data.size() - free));
+    ASSERT_EQ(getCapacity(buffer), initial * 4);
+    ASSERT_EQ(buffer->getPosInputBuffer(), data.size());
+    ASSERT_EQ(memcmp(buffer->getInputBuffer(), data.data(), data.size()), 0);
+    /*
+     * Блок прежнего класса вернулся в пул
+     */
+    size_t length = 1;
+    ASSERT_EQ(pool.allocate(length), first);
+    pool.deallocate(first, length);
+    /*
+     * Перелив сверх максимального размера не принимается
+     */
+    onyxup::BufferPool limited(initial * 2);
+    onyxup::PtrBuffer small = limited.getBuffer();
+    ASSERT_EQ(small->reserveInputBuffer(initial * 4), initial * 2);
+    small->commitInputBuffer(initial * 2);
+    ASSERT_FALSE(small->addDataToInputBuffer(data.data(), 1));
+    ASSERT_EQ(small->getPosInputBuffer(), initial * 2);
+    limited.releaseBuffer(small);
+    pool.releaseBuffer(buffer);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
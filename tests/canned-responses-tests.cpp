@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../sources/response/canned-responses.h"
+#include "../sources/response/response-states.h"
+#include "../sources/response/http-date.h"
+
+class CannedResponsesTests : public ::testing::Test {
+
+public:
+
+    CannedResponsesTests() {
+    }
+
+    ~CannedResponsesTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(CannedResponsesTests, Test_1) {
+    onyxup::CannedResponses responses;
+    const onyxup::CannedResponses::Entry &entry = responses.get(onyxup::CannedResponse::SERVICE_UNAVAILABLE);
+    ASSERT_EQ(entry.code, onyxup::ResponseState::RESPONSE_STATE_SERVICE_UNAVAILABLE_CODE);
+    const std::string &header = *entry.header;
+    ASSERT_EQ(header.compare(0, 12, "HTTP/1.1 503"), 0);
+    ASSERT_NE(header.find("\r\nContent-Length: " + std::to_string(entry.body->size()) + "\r\n"), std::string::npos);
+    ASSERT_EQ(header.compare(entry.dateOffset - 8, 8, "\r\nDate: "), 0);
+    ASSERT_EQ(header.compare(entry.dateOffset + 25, 4, " GMT"), 0);
+}
+
+TEST_F(CannedResponsesTests, Test_2) {
+    onyxup::CannedResponses responses;
+    const char *first_date = "Sun, 06 Nov 1994 08:49:37 GMT";
+    const char *second_date = "Sun, 06 Nov 1994 08:49:38 GMT";
+    std::shared_ptr<const std::string> header = responses.get(onyxup::CannedResponse::NOT_FOUND, first_date).header;
+    std::shared_ptr<const std::string> body = responses.get(onyxup::CannedResponse::NOT_FOUND, first_date).body;
+    std::string copy = *header;
+    ASSERT_NE(copy.find(std::string("\r\nDate: ") + first_date + "\r\n"), std::string::npos);
+    /*
+     * Строки не меняются на месте: в пределах секунды возвращается тот же заголовок,
+     * после смены секунды - новый, а ранее выданный остается прежним
+     */
+    const onyxup::CannedResponses::Entry &same = responses.get(onyxup::CannedResponse::NOT_FOUND, first_date);
+    ASSERT_EQ(same.header, header);
+    ASSERT_EQ(same.body, body);
+    const onyxup::CannedResponses::Entry &entry = responses.get(onyxup::CannedResponse::NOT_FOUND, second_date);
+    ASSERT_NE(entry.header, header);
+    ASSERT_EQ(entry.body, body);
+    ASSERT_EQ(entry.header->compare(entry.dateOffset, onyxup::HttpDate::LENGTH, second_date), 0);
+    ASSERT_EQ(entry.header->size(), copy.size());
+    ASSERT_EQ(*header, copy);
+    ASSERT_EQ(responses.get(onyxup::CannedResponse::REQUEST_TIMEOUT).code,
+              onyxup::ResponseState::RESPONSE_STATE_METHOD_REQUEST_TIMEOUT_CODE);
+    ASSERT_EQ(responses.get(onyxup::CannedResponse::PAYLOAD_TOO_LARGE).code,
+              onyxup::ResponseState::RESPONSE_STATE_PAYLOAD_TOO_LARGE_CODE);
+}
+TEST_F(CannedResponsesTests, Test_3) {
+    /*
+     * Ответ перед закрытием соединения не обещает его сохранить
+     */
+    onyxup::CannedResponses responses;
+    const onyxup::CannedResponses::Entry &keep = responses.get(onyxup::CannedResponse::SERVICE_UNAVAILABLE);
+    std::string_view date = onyxup::HttpDate::now();
+    const onyxup::CannedResponses::Entry &close = responses.get(onyxup::CannedResponse::SERVICE_UNAVAILABLE, date, true);
+    ASSERT_NE(keep.header->find("\r\nConnection: Keep-Alive\r\n"), std::string::npos);
+    ASSERT_EQ(keep.header->find("Connection: close"), std::string::npos);
+    ASSERT_NE(close.header->find("\r\nConnection: close\r\n"), std::string::npos);
+    ASSERT_EQ(close.header->find("Keep-Alive"), std::string::npos);
+    ASSERT_EQ(close.body, responses.get(onyxup::CannedResponse::SERVICE_UNAVAILABLE, date, true).body);
+    ASSERT_EQ(close.code, keep.code);
+    ASSERT_EQ(*close.body, *keep.body);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
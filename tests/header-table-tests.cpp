@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <ctype.h>
+
+#include "../sources/request/header-table.h"
+
+class HeaderTableTests : public ::testing::Test {
+
+public:
+
+    HeaderTableTests() {
+    }
+
+    ~HeaderTableTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(HeaderTableTests, Test_1) {
+    onyxup::HeaderTable table;
+    table.add("Host", "localhost");
+    table.add("Content-Length", "10");
+    table.add("X-Request-Id", "abc");
+    ASSERT_EQ(table.size(), 3);
+    ASSERT_EQ(*table.find("host"), "localhost");
+    ASSERT_EQ(*table.find("CONTENT-LENGTH"), "10");
+    ASSERT_EQ(*table.find("x-request-id"), "abc");
+    ASSERT_EQ(*table.find(onyxup::HttpHeader::HOST), "localhost");
+    ASSERT_EQ(*table.find(onyxup::HttpHeader::CONTENT_LENGTH), "10");
+    ASSERT_FALSE(table.find(onyxup::HttpHeader::CONNECTION));
+    ASSERT_FALSE(table.find("x-request"));
+    ASSERT_FALSE(table.find("accept"));
+}
+
+TEST_F(HeaderTableTests, Test_2) {
+    /*
+     * Переполнение встроенного массива
+     */
+    std::vector<std::string> names;
+    for (size_t i = 0; i < onyxup::HeaderTable::INLINE_CAPACITY * 2; i++)
+        names.push_back("X-Header-" + std::to_string(i));
+    onyxup::HeaderTable table;
+    for (auto &name : names)
+        table.add(name, name);
+    table.add("Range", "bytes=0-1");
+    ASSERT_EQ(table.size(), names.size() + 1);
+    for (auto &name : names)
+        ASSERT_EQ(*table.find(name), name);
+    ASSERT_EQ(*table.find(onyxup::HttpHeader::RANGE), "bytes=0-1");
+    size_t count = 0;
+    for (auto &header : table)
+        count += header.name == header.value;
+    ASSERT_EQ(count, names.size());
+    table.clear();
+    ASSERT_TRUE(table.empty());
+    ASSERT_FALSE(table.find(onyxup::HttpHeader::RANGE));
+    table.add("Connection", "close");
+    ASSERT_EQ(*table.find("connection"), "close");
+}
+
+TEST_F(HeaderTableTests, Test_3) {
+    onyxup::HeaderTable table;
+    table.add("Connection", "keep-alive");
+    table.add("connection", "close");
+    ASSERT_EQ(*table.find(onyxup::HttpHeader::CONNECTION), "keep-alive");
+    ASSERT_TRUE(table.replace("CONNECTION", "upgrade"));
+    ASSERT_EQ(*table.find("Connection"), "upgrade");
+    ASSERT_FALSE(table.replace("accept", "*/*"));
+}
+
+TEST_F(HeaderTableTests, Test_4) {
+    /*
+     * Сравнение по 8 байт совпадает с побайтовым tolower для всех значений байта
+     */
+    for (int c = 0; c < 256; c++) {
+        uint64_t word = 0;
+        for (int i = 0; i < 8; i++)
+            word |= (uint64_t) (unsigned char) c << (i * 8);
+        uint64_t lower = onyxup::header::toLowerAscii8(word);
+        unsigned char expected = (c >= 'A' && c <= 'Z') ? c + 32 : c;
+        for (int i = 0; i < 8; i++)
+            ASSERT_EQ((lower >> (i * 8)) & 0xff, expected) << c;
+    }
+    ASSERT_TRUE(onyxup::header::equalsIgnoreCase("Accept-Encoding", "accept-encoding"));
+    ASSERT_TRUE(onyxup::header::equalsIgnoreCase("X-LONG-HEADER-NAME-1", "x-long-header-name-1"));
+    ASSERT_FALSE(onyxup::header::equalsIgnoreCase("X-LONG-HEADER-NAME-1", "x-long-header-name-2"));
+    ASSERT_FALSE(onyxup::header::equalsIgnoreCase("abc-def@", "abc-def`"));
+    ASSERT_FALSE(onyxup::header::equalsIgnoreCase("content-", "content\r"));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../sources/response/http-date.h"
+#include "../sources/response/response-base.h"
+#include "../sources/response/response-states.h"
+
+class HttpDateTests : public ::testing::Test {
+
+public:
+
+    HttpDateTests() {
+    }
+
+    ~HttpDateTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(HttpDateTests, Test_1) {
+    char out[onyxup::HttpDate::LENGTH];
+    onyxup::HttpDate::format(784111777, out);
+    ASSERT_EQ(std::string(out, sizeof(out)), "Sun, 06 Nov 1994 08:49:37 GMT");
+    onyxup::HttpDate::format(0, out);
+    ASSERT_EQ(std::string(out, sizeof(out)), "Thu, 01 Jan 1970 00:00:00 GMT");
+    std::string_view now = onyxup::HttpDate::now();
+    ASSERT_EQ(now.size(), onyxup::HttpDate::LENGTH);
+    ASSERT_EQ(now.substr(now.size() - 4), " GMT");
+}
+
+TEST_F(HttpDateTests, Test_2) {
+    onyxup::ResponseBase::setServerAddress("127.0.0.1", 8080);
+    onyxup::ResponseBase response(onyxup::ResponseState::RESPONSE_STATE_OK_CODE,
+                                  onyxup::ResponseState::RESPONSE_STATE_OK_MSG, "text/plain", std::string("body"));
+    response.addHeader("Content-Length", "4");
+    std::string header, body;
+    response.release(header, body);
+    ASSERT_EQ(header.compare(0, 17, "HTTP/1.1 200 OK\r\n"), 0);
+    ASSERT_NE(header.find("\r\nHost: 127.0.0.1:8080\r\n"), std::string::npos);
+    ASSERT_NE(header.find("\r\nDate: " + std::string(onyxup::HttpDate::now()) + "\r\n"), std::string::npos);
+    ASSERT_NE(header.find("\r\nContent-Type: text/plain\r\n"), std::string::npos);
+    ASSERT_NE(header.find("\r\nContent-Length: 4\r\n"), std::string::npos);
+    ASSERT_EQ(header.compare(header.size() - 4, 4, "\r\n\r\n"), 0);
+    ASSERT_EQ(body, "body");
+    /*
+     * Код с собственным текстом статуса формируется без таблицы
+     */
+    onyxup::ResponseBase custom(299, "Custom", "text/plain");
+    ASSERT_EQ(custom.toString().compare(0, 21, "HTTP/1.1 299 Custom\r\n"), 0);
+    onyxup::ResponseBase found(onyxup::ResponseState::RESPONSE_STATE_FOUND_CODE,
+                               onyxup::ResponseState::RESPONSE_STATE_FOUND_MSG, "text/plain");
+    ASSERT_EQ(found.toString().compare(0, 20, "HTTP/1.1 302 Found\r\n"), 0);
+}
+
+TEST_F(HttpDateTests, Test_3) {
+    time_t time;
+    ASSERT_TRUE(onyxup::HttpDate::parse("Sun, 06 Nov 1994 08:49:37 GMT", time));
+    ASSERT_EQ(time, 784111777);
+    char out[onyxup::HttpDate::LENGTH];
+    onyxup::HttpDate::format(1700000000, out);
+    ASSERT_TRUE(onyxup::HttpDate::parse(std::string_view(out, sizeof(out)), time));
+    ASSERT_EQ(time, 1700000000);
+    /*
+     * Устаревшие форматы (RFC 850, asctime) и испорченные даты не разбираются
+     */
+    ASSERT_FALSE(onyxup::HttpDate::parse("Sunday, 06-Nov-94 08:49:37 GMT", time));
+    ASSERT_FALSE(onyxup::HttpDate::parse("Sun Nov  6 08:49:37 1994", time));
+    ASSERT_FALSE(onyxup::HttpDate::parse("Sun, 06 Xyz 1994 08:49:37 GMT", time));
+    ASSERT_FALSE(onyxup::HttpDate::parse("Sun, 06 Nov 1994 08:4a:37 GMT", time));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "../sources/queue/lock-free-queue.h"
+
+class LockFreeQueueTests : public ::testing::Test {
+
+public:
+
+    LockFreeQueueTests() {
+    }
+
+    ~LockFreeQueueTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(LockFreeQueueTests, Test_1) {
+    onyxup::LockFreeQueue<int> queue(4);
+    int value = 0;
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.try_pop(value));
+    for (int i = 0; i < 4; i++)
+        ASSERT_TRUE(queue.try_push(i));
+    ASSERT_FALSE(queue.try_push(4));
+    ASSERT_EQ(queue.size(), 4);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(queue.try_pop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_TRUE(queue.empty());
+}
+TEST_F(LockFreeQueueTests, Test_2) {
+    onyxup::LockFreeQueue<int> queue(5);
+    ASSERT_EQ(queue.capacity(), 8);
+}
+TEST_F(LockFreeQueueTests, Test_3) {
+    /*
+     * Несколько производителей и потребителей, потребители спят на пустой очереди
+     */
+    const int producers = 4, consumers = 4, count = 100000;
+    onyxup::LockFreeQueue<long> queue(1024);
+    std::atomic<long> sum{0};
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < consumers; i++)
+        threads.emplace_back([&] {
+            for (;;) {
+                long value;
+                queue.wait_and_pop(value);
+                if (value < 0)
+                    return;
+                sum += value;
+                received++;
+            }
+        });
+    for (int i = 0; i < producers; i++)
+        threads.emplace_back([&] {
+            for (long j = 1; j <= count; j++)
+                queue.push(j);
+        });
+    for (int i = consumers; i < consumers + producers; i++)
+        threads[i].join();
+    for (int i = 0; i < consumers; i++)
+        queue.push(-1);
+    for (int i = 0; i < consumers; i++)
+        threads[i].join();
+    ASSERT_EQ(received.load(), producers * count);
+    ASSERT_EQ(sum.load(), (long) producers * count * (count + 1) / 2);
+}
+
+TEST_F(LockFreeQueueTests, Test_4) {
+    /*
+     * notify между prepareWait и cancelWait не мешает разбудить следующего спящего
+     */
+    onyxup::EventCount events;
+    events.prepareWait();
+    events.notify();
+    events.cancelWait();
+    std::atomic<bool> registered{false};
+    std::atomic<bool> woken{false};
+    std::thread thread([&] {
+        uint32_t key = events.prepareWait();
+        registered = true;
+        events.wait(key);
+        woken = true;
+    });
+    while (!registered.load())
+        std::this_thread::yield();
+    /*
+     * Ждем, пока поток заснет, затем будим его
+     */
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    events.notify();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!woken.load() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (!woken.load()) {
+        thread.detach();
+        FAIL() << "notify не разбудил ожидающий поток";
+    }
+    thread.join();
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../sources/server/utils.h"
+
+class MatchETagTests : public ::testing::Test {
+
+public:
+
+    MatchETagTests() {
+    }
+
+    ~MatchETagTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(MatchETagTests, Test_1) {
+    ASSERT_TRUE(onyxup::utils::matchETag("\"a-1\"", "\"a-1\""));
+    ASSERT_FALSE(onyxup::utils::matchETag("\"a-2\"", "\"a-1\""));
+    ASSERT_FALSE(onyxup::utils::matchETag("", "\"a-1\""));
+}
+
+TEST_F(MatchETagTests, Test_2) {
+    ASSERT_TRUE(onyxup::utils::matchETag("\"b\", \"a-1\"", "\"a-1\""));
+    ASSERT_TRUE(onyxup::utils::matchETag("\"b\",\t W/\"a-1\" ", "\"a-1\""));
+    ASSERT_FALSE(onyxup::utils::matchETag("\"b\", \"c\"", "\"a-1\""));
+}
+
+TEST_F(MatchETagTests, Test_3) {
+    ASSERT_TRUE(onyxup::utils::matchETag("*", "\"a-1\""));
+    ASSERT_TRUE(onyxup::utils::matchETag(" * ", "\"a-1\""));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
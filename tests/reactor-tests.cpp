@@ -0,0 +1,335 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "../sources/server/server.h"
+#include "../sources/server/reactor.h"
+
+/*
+ * Тесты реактора на настоящем сервере: сервер запускается в дочернем процессе,
+ * тест общается с ним через сокет
+ */
+class ReactorTests : public ::testing::Test {
+
+public:
+
+    static pid_t serverPid;
+    static int port;
+    /*
+     * Число выполненных обработчиков /fast, общее с процессом сервера
+     */
+    static std::atomic<int> *counterFast;
+
+    ReactorTests() {
+    }
+
+    ~ReactorTests() {
+    }
+
+    static void SetUpTestCase() {
+        void *shared = mmap(nullptr, sizeof(std::atomic<int>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        ASSERT_NE(shared, MAP_FAILED);
+        counterFast = new(shared) std::atomic<int>(0);
+        port = 20000 + getpid() % 10000;
+        serverPid = fork();
+        ASSERT_NE(serverPid, -1);
+        if (serverPid == 0) {
+            onyxup::HttpServer::setNumberReactors(1);
+            onyxup::HttpServer *server = new onyxup::HttpServer(port, 4);
+            server->addRoute("GET", "^/slow$", [](onyxup::PtrCRequest) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+                return onyxup::ResponseBase(200, "OK", "text/plain", std::string("slow"));
+            }, onyxup::EnumTaskType::LOCAL_TASK);
+            server->addRoute("GET", "^/fast/.+$", [](onyxup::PtrCRequest request) {
+                (*counterFast)++;
+                return onyxup::ResponseBase(200, "OK", "text/plain", std::string(request->getFullURIRef()));
+            }, onyxup::EnumTaskType::LOCAL_TASK);
+            server->addRoute("POST", "^/echo$", [](onyxup::PtrCRequest request) {
+                return onyxup::ResponseBase(200, "OK", "text/plain", request->getBody());
+            }, onyxup::EnumTaskType::LOCAL_TASK);
+            server->addRoute("GET", "^/misuse$", [](onyxup::PtrCRequest, onyxup::ResponseWriter &writer) {
+                writer.write("partial");
+                writer.header("X-Late", "1");
+            }, onyxup::EnumTaskType::LOCAL_TASK);
+            server->run();
+            _exit(0);
+        }
+        /*
+         * Ждем, пока сервер начнет принимать соединения
+         */
+        for (int i = 0; i < 500; i++) {
+            int fd = connectToServer();
+            if (fd != -1) {
+                close(fd);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        FAIL() << "Сервер не запустился";
+    }
+
+    static void TearDownTestCase() {
+        if (serverPid > 0) {
+            kill(serverPid, SIGKILL);
+            waitpid(serverPid, nullptr, 0);
+        }
+        munmap(counterFast, sizeof(std::atomic<int>));
+    }
+
+    void SetUp() {
+        *counterFast = 0;
+    }
+
+    void TearDown() {
+    }
+
+    static int connectToServer() {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+            close(fd);
+            return -1;
+        }
+        struct timeval timeout = {5, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        int flag = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        return fd;
+    }
+
+    static bool sendAll(int fd, const std::string &data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t res = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+            if (res <= 0)
+                return false;
+            done += res;
+        }
+        return true;
+    }
+
+    /*
+     * Читает один ответ с Content-Length, возвращает его тело или пустую строку при ошибке.
+     * Данные следующих ответов остаются в pending
+     */
+    static std::string readResponseBody(int fd, std::string &pending) {
+        for (;;) {
+            size_t end = pending.find("\r\n\r\n");
+            if (end != std::string::npos) {
+                size_t pos = pending.find("Content-Length: ");
+                if (pos == std::string::npos || pos > end)
+                    return std::string();
+                size_t length = std::stoul(pending.substr(pos + 16));
+                if (pending.size() >= end + 4 + length) {
+                    std::string body = pending.substr(end + 4, length);
+                    pending.erase(0, end + 4 + length);
+                    return body;
+                }
+            }
+            char buffer[16 * 1024];
+            ssize_t res = recv(fd, buffer, sizeof(buffer), 0);
+            if (res <= 0)
+                return std::string();
+            pending.append(buffer, res);
+        }
+    }
+
+};
+
+pid_t ReactorTests::serverPid = -1;
+int ReactorTests::port = 0;
+std::atomic<int> *ReactorTests::counterFast = nullptr;
+
+TEST_F(ReactorTests, Test_1) {
+    /*
+     * Медленный запрос и быстрые за ним в одном соединении: быстрые выполняются раньше,
+     * но ответы приходят в порядке запросов
+     */
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    const int count = 8;
+    std::string requests = "GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    for (int i = 0; i < count; i++)
+        requests += "GET /fast/" + std::to_string(i) + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ASSERT_TRUE(sendAll(fd, requests));
+    std::string pending;
+    ASSERT_EQ(readResponseBody(fd, pending), "slow");
+    ASSERT_EQ(counterFast->load(), count);
+    for (int i = 0; i < count; i++)
+        ASSERT_EQ(readResponseBody(fd, pending), "/fast/" + std::to_string(i));
+    close(fd);
+}
+TEST_F(ReactorTests, Test_2) {
+    /*
+     * Пока медленный ответ не отправлен, соединение разбирает не больше MAX_PIPELINE_DEPTH
+     * запросов, остальные ждут во входном буфере и выполняются после его отправки
+     */
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    const int depth = (int) onyxup::Reactor::MAX_PIPELINE_DEPTH;
+    const int count = depth + 16;
+    std::string requests = "GET /slow HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    for (int i = 0; i < count; i++)
+        requests += "GET /fast/" + std::to_string(i) + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ASSERT_TRUE(sendAll(fd, requests));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    ASSERT_EQ(counterFast->load(), depth - 1);
+    std::string pending;
+    ASSERT_EQ(readResponseBody(fd, pending), "slow");
+    for (int i = 0; i < count; i++)
+        ASSERT_EQ(readResponseBody(fd, pending), "/fast/" + std::to_string(i));
+    ASSERT_EQ(counterFast->load(), count);
+    close(fd);
+}
+TEST_F(ReactorTests, Test_3) {
+    /*
+     * Chunked тело приходит несколькими частями, граница проходит внутри размера и данных чанка
+     */
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string header = "POST /echo HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n";
+    std::vector<std::string> parts = {header + "5\r\nhel", "lo\r\n1", "0\r\n0123456789abcdef\r", "\n0\r\n\r\n"};
+    for (auto &part : parts) {
+        ASSERT_TRUE(sendAll(fd, part));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    std::string pending;
+    ASSERT_EQ(readResponseBody(fd, pending), "hello0123456789abcdef");
+    close(fd);
+}
+TEST_F(ReactorTests, Test_4) {
+    /*
+     * Трейлер после последнего чанка пропускается, запрос за chunked телом разбирается
+     */
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string requests = "POST /echo HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "4\r\nabcd\r\n3;ext=1\r\nefg\r\n0\r\nX-Checksum: 1\r\nX-Other: 2\r\n\r\n"
+                           "GET /fast/after HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                           "POST /echo HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+                           "2\r\nxy\r\n0\r\n\r\n"
+                           "GET /fast/last HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    ASSERT_TRUE(sendAll(fd, requests));
+    std::string pending;
+    ASSERT_EQ(readResponseBody(fd, pending), "abcdefg");
+    ASSERT_EQ(readResponseBody(fd, pending), "/fast/after");
+    ASSERT_EQ(readResponseBody(fd, pending), "xy");
+    ASSERT_EQ(readResponseBody(fd, pending), "/fast/last");
+    close(fd);
+}
+TEST_F(ReactorTests, Test_5) {
+    /*
+     * Некорректный размер чанка - соединение закрывается без ответа
+     */
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    std::string request = "POST /echo HTTP/1.1\r\nHost: localhost\r\nTransfer-Encoding: chunked\r\n\r\n"
+                          "zz\r\nabcd\r\n0\r\n\r\n";
+    ASSERT_TRUE(sendAll(fd, request));
+    char buffer[256];
+    ASSERT_EQ(recv(fd, buffer, sizeof(buffer), 0), 0);
+    close(fd);
+}
+TEST_F(ReactorTests, Test_6) {
+    /*
+     * Ответ воркера закрывает соединение, а за ним уже пришли байты следующего запроса
+     * и закрытие передачи клиентом: события по закрытому соединению пропускаются,
+     * сервер продолжает принимать соединения
+     */
+    const int rounds = 200;
+    const int connections = 32;
+    for (int round = 0; round < rounds; round++) {
+        std::vector<int> fds;
+        for (int i = 0; i < connections; i++) {
+            int fd = connectToServer();
+            ASSERT_NE(fd, -1);
+            std::string requests = "GET /fast/close HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n"
+                                   "GET /fast/more HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            ASSERT_TRUE(sendAll(fd, requests));
+            shutdown(fd, SHUT_WR);
+            fds.push_back(fd);
+        }
+        /*
+         * Новое соединение может получить дескриптор только что закрытого - его не должно
+         * закрыть запоздавшее событие прежнего соединения
+         */
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        ASSERT_TRUE(sendAll(fd, "GET /fast/alive HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+        std::string pending;
+        ASSERT_EQ(readResponseBody(fd, pending), "/fast/alive");
+        close(fd);
+        for (int fd : fds) {
+            char buffer[4096];
+            ssize_t res;
+            while ((res = recv(fd, buffer, sizeof(buffer), 0)) > 0);
+            ASSERT_TRUE(res == 0 || errno != EAGAIN) << "Сервер не закрыл соединение";
+            close(fd);
+        }
+    }
+}
+TEST_F(ReactorTests, Test_7) {
+    /*
+     * Заголовок Connection соответствует тому, закрывает ли сервер соединение после ответа
+     */
+    const char *requests[][2] = {
+        {"GET /fast/keep HTTP/1.1\r\nHost: localhost\r\n\r\n", "Connection: Keep-Alive"},
+        {"GET /fast/close HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n", "Connection: close"},
+        {"GET /fast/old HTTP/1.0\r\n\r\n", "Connection: close"},
+        {"GET /missing HTTP/1.0\r\n\r\n", "Connection: close"},
+        {"GET /missing HTTP/1.0\r\nConnection: keep-alive\r\n\r\n", "Connection: Keep-Alive"}
+    };
+    for (auto &request : requests) {
+        int fd = connectToServer();
+        ASSERT_NE(fd, -1);
+        ASSERT_TRUE(sendAll(fd, request[0]));
+        std::string header;
+        char buffer[4096];
+        ssize_t res;
+        while (header.find("\r\n\r\n") == std::string::npos && (res = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+            header.append(buffer, res);
+        header = header.substr(0, header.find("\r\n\r\n"));
+        ASSERT_NE(header.find(request[1]), std::string::npos) << request[0];
+        close(fd);
+    }
+}
+TEST_F(ReactorTests, Test_8) {
+    /*
+     * Исключение в обработчике (заголовок после тела) превращается в ответ 500,
+     * соединение и сервер продолжают работать
+     */
+    int fd = connectToServer();
+    ASSERT_NE(fd, -1);
+    ASSERT_TRUE(sendAll(fd, "GET /misuse HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                            "GET /fast/after HTTP/1.1\r\nHost: localhost\r\n\r\n"));
+    std::string pending;
+    char buffer[4096];
+    ssize_t res;
+    while (pending.find("\r\n\r\n") == std::string::npos && (res = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+        pending.append(buffer, res);
+    std::string status = "HTTP/1.1 500 Internal Server Error\r\n";
+    ASSERT_EQ(pending.compare(0, status.size(), status), 0);
+    ASSERT_EQ(readResponseBody(fd, pending), "");
+    ASSERT_EQ(readResponseBody(fd, pending), "/fast/after");
+    close(fd);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
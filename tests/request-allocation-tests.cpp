@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <string>
+
+#include "../sources/request/request.h"
+#include "../sources/server/utils.h"
+#include "../sources/task/task-pool.h"
+
+/*
+ * Подсчет выделений памяти через замену глобального operator new
+ */
+static std::atomic<size_t> allocations{0};
+
+/*
+ * Выделения больше failAllocationsAbove байт завершаются ошибкой, как при нехватке памяти
+ */
+static std::atomic<size_t> failAllocationsAbove{(size_t) -1};
+
+void * operator new(size_t size) {
+    allocations++;
+    void *ptr = size > failAllocationsAbove ? nullptr : malloc(size ? size : 1);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept {
+    allocations++;
+    return size > failAllocationsAbove ? nullptr : malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+    free(ptr);
+}
+
+class RequestAllocationTests : public ::testing::Test {
+
+public:
+
+    RequestAllocationTests() {
+    }
+
+    ~RequestAllocationTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+    static std::string makeRequest(int numberHeaders) {
+        std::string raw = "GET /api/items HTTP/1.1\r\n";
+        for (int i = 0; i < numberHeaders; i++)
+            raw += "X-Header-" + std::to_string(i) + ": value-" + std::to_string(i) + "\r\n";
+        raw += "\r\n";
+        return raw;
+    }
+
+    /*
+     * Количество выделений памяти от разбора заголовка до передачи запроса задаче
+     */
+    static size_t countAllocations(int numberHeaders) {
+        std::string raw = makeRequest(numberHeaders);
+        onyxup::PtrRequest request = onyxup::req::requestFactory();
+        int version;
+        size_t before = allocations.load();
+        int result = request->parseHeader(raw.data(), raw.size(), 0, version);
+        onyxup::utils::parseParamsRequest(request, request->getFullURIRef().size());
+        onyxup::PtrRequest task_request = onyxup::req::requestMoveFactory(request);
+        size_t count = allocations.load() - before;
+        EXPECT_EQ(result, (int) raw.size());
+        EXPECT_EQ(task_request->getHeaders().size(), (size_t) numberHeaders);
+        delete task_request;
+        delete request;
+        return count;
+    }
+};
+
+TEST_F(RequestAllocationTests, Test_1) {
+    size_t one_header = countAllocations(1);
+    size_t twenty_headers = countAllocations(20);
+    ASSERT_EQ(one_header, twenty_headers);
+    /*
+     * storage и запрос задачи, таблица заголовков встроена в запрос
+     */
+    ASSERT_LE(twenty_headers, 2u);
+}
+
+TEST_F(RequestAllocationTests, Test_2) {
+    std::string raw = "POST /echo?a=1&b=2 HTTP/1.1\r\nHost: localhost\r\nContent-Length: 5\r\n\r\nhello";
+    onyxup::PtrRequest request = onyxup::req::requestFactory();
+    int version;
+    ASSERT_EQ(request->parseHeader(raw.data(), raw.size(), 0, version), (int) raw.size() - 5);
+    onyxup::utils::parseParamsRequest(request, request->getFullURIRef().size());
+    request->setBody(raw.data() + request->getHeaderLength(), 5);
+    /*
+     * Входной буфер соединения переиспользуется - запрос от него не зависит
+     */
+    raw.assign(raw.size(), 'x');
+    onyxup::PtrRequest task_request = onyxup::req::requestMoveFactory(request);
+    ASSERT_EQ(version, 1);
+    ASSERT_EQ(task_request->getMethodRef(), "POST");
+    ASSERT_EQ(task_request->getFullURIRef(), "/echo?a=1&b=2");
+    ASSERT_EQ(task_request->getURIRef(), "/echo");
+    ASSERT_EQ(task_request->getHeaderRef("host"), "localhost");
+    ASSERT_EQ(task_request->getHeaderRef("content-length"), "5");
+    ASSERT_EQ(task_request->getBodyRef(), "hello");
+    ASSERT_EQ(task_request->getParams().at("b"), "2");
+    ASSERT_THROW(task_request->getHeaderRef("accept"), std::out_of_range);
+    ASSERT_TRUE(request->getFullURIRef().empty());
+    ASSERT_TRUE(request->getHeaders().empty());
+    delete task_request;
+    delete request;
+}
+
+TEST_F(RequestAllocationTests, Test_3) {
+    onyxup::PtrRequest request = onyxup::req::requestFactory();
+    std::string uri = "/test?x=1";
+    request->setFullURI(uri.c_str(), uri.size());
+    for (int i = 0; i < 50; i++)
+        request->addHeader("header-" + std::to_string(i), "value-" + std::to_string(i));
+    request->addHeader("header-7", "changed");
+    onyxup::PtrRequest copy = onyxup::req::requestCopyFactory(request);
+    delete request;
+    ASSERT_EQ(copy->getFullURIRef(), "/test?x=1");
+    ASSERT_EQ(copy->getHeaders().size(), 50u);
+    ASSERT_EQ(copy->getHeaderRef("header-0"), "value-0");
+    ASSERT_EQ(copy->getHeaderRef("header-7"), "changed");
+    ASSERT_EQ(copy->getHeaderRef("header-49"), "value-49");
+    delete copy;
+}
+
+TEST_F(RequestAllocationTests, Test_4) {
+    /*
+     * Задачи из пула: после первого запроса буферы переиспользуются и память не выделяется
+     */
+    std::string raw = makeRequest(20);
+    onyxup::TaskPool pool(4);
+    onyxup::PtrRequest request = onyxup::req::requestFactory();
+    size_t before = 0;
+    for (int i = 0; i < 3; i++) {
+        if (i == 2)
+            before = allocations.load();
+        int version;
+        request->parseHeader(raw.data(), raw.size(), 0, version);
+        onyxup::utils::parseParamsRequest(request, request->getFullURIRef().size());
+        onyxup::PtrTask task = pool.acquire();
+        onyxup::req::moveRequest(task->getRequest(), request);
+        EXPECT_EQ(task->getRequest()->getHeaders().size(), 20u);
+        EXPECT_EQ(task->getRequest()->getURIRef(), "/api/items");
+        pool.release(task);
+    }
+    ASSERT_EQ(allocations.load() - before, 0u);
+    delete request;
+}
+
+TEST_F(RequestAllocationTests, Test_5) {
+    /*
+     * Нехватка памяти под storage не бросает исключение: разбор возвращает -3,
+     * setBody - false, запрос остается прежним
+     */
+    std::string raw = "POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: 4096\r\n\r\n";
+    std::string body(4096, 'b');
+    onyxup::PtrRequest request = onyxup::req::requestFactory();
+    int version;
+    failAllocationsAbove = 16;
+    ASSERT_EQ(request->parseHeader(raw.data(), raw.size(), 0, version), -3);
+    failAllocationsAbove = (size_t) -1;
+    ASSERT_EQ(request->parseHeader(raw.data(), raw.size(), 0, version), (int) raw.size());
+    failAllocationsAbove = 1024;
+    ASSERT_FALSE(request->setBody(body.data(), body.size()));
+    failAllocationsAbove = (size_t) -1;
+    ASSERT_TRUE(request->getBodyRef().empty());
+    ASSERT_EQ(request->getFullURIRef(), "/echo");
+    ASSERT_EQ(request->getHeaderRef("host"), "localhost");
+    ASSERT_TRUE(request->setBody(body.data(), body.size()));
+    ASSERT_EQ(request->getBodyRef(), body);
+    delete request;
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "../sources/queue/response-queue.h"
+#include "../sources/task/task-pool.h"
+
+class ResponseQueueTests : public ::testing::Test {
+
+public:
+
+    ResponseQueueTests() {
+    }
+
+    ~ResponseQueueTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+static onyxup::PtrTask makeTask(onyxup::TaskPool &pool, const std::string &body, bool performed) {
+    onyxup::PtrTask task = pool.acquire();
+    onyxup::ResponseBase response(200, "OK", "text/plain", body);
+    task->setResponse(response);
+    task->setPerformed(performed);
+    return task;
+}
+
+static std::string collect(const struct iovec *iov, size_t count) {
+    std::string data;
+    for (size_t i = 0; i < count; i++)
+        data.append((const char *) iov[i].iov_base, iov[i].iov_len);
+    return data;
+}
+
+TEST_F(ResponseQueueTests, Test_1) {
+    onyxup::TaskPool pool(4);
+    onyxup::ResponseQueue queue;
+    onyxup::PtrTask first = makeTask(pool, "first", true);
+    onyxup::PtrTask second = makeTask(pool, "", true);
+    onyxup::PtrTask third = makeTask(pool, "third", false);
+    queue.push(first);
+    queue.push(second);
+    queue.push(third);
+    struct iovec iov[8];
+    /*
+     * Отправляются только готовые ответы из начала очереди, пустое тело не попадает в iov
+     */
+    size_t count = queue.fill(iov, 8);
+    ASSERT_EQ(count, 3);
+    std::string expected = first->getResponseHeader() + "first" + second->getResponseHeader();
+    ASSERT_EQ(collect(iov, count), expected);
+    ASSERT_EQ(queue.fill(iov, 2), 2);
+    pool.release(queue.pop());
+    pool.release(queue.pop());
+    pool.release(queue.pop());
+}
+
+TEST_F(ResponseQueueTests, Test_2) {
+    onyxup::TaskPool pool(4);
+    onyxup::ResponseQueue queue;
+    onyxup::PtrTask first = makeTask(pool, "first", true);
+    onyxup::PtrTask second = makeTask(pool, "second", true);
+    queue.push(first);
+    queue.push(second);
+    std::string expected = first->getResponseHeader() + "first" + second->getResponseHeader() + "second";
+    std::vector<onyxup::PtrTask> released;
+    auto release = [&released](onyxup::PtrTask task) { released.push_back(task); };
+    struct iovec iov[8];
+    /*
+     * Отправка частями: внутри заголовка, на границе заголовка и тела, через границу ответов
+     */
+    size_t offset = 0;
+    size_t steps[] = {3, first->getResponseHeader().size() - 3, 2, 10};
+    for (size_t step : steps) {
+        ASSERT_EQ(collect(iov, queue.fill(iov, 8)), expected.substr(offset));
+        queue.consume(step, release);
+        offset += step;
+    }
+    ASSERT_EQ(released.size(), 1);
+    ASSERT_EQ(released[0], first);
+    ASSERT_EQ(queue.front(), second);
+    ASSERT_EQ(collect(iov, queue.fill(iov, 8)), expected.substr(offset));
+    queue.consume(expected.size() - offset, release);
+    ASSERT_EQ(released.size(), 2);
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.getSent(), 0);
+    for (auto task : released)
+        pool.release(task);
+}
+
+TEST_F(ResponseQueueTests, Test_3) {
+    char path[] = "/tmp/onyxup-queue-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_EQ(write(fd, "0123456789", 10), 10);
+    close(fd);
+    onyxup::TaskPool pool(4);
+    onyxup::ResponseQueue queue;
+    onyxup::PtrTask first = pool.acquire();
+    onyxup::ResponseBase response(200, "OK", "text/plain");
+    response.setFile(onyxup::StaticFile::open(path));
+    response.setFileRange(2, 6);
+    first->setResponse(response);
+    first->setPerformed(true);
+    unlink(path);
+    onyxup::PtrTask second = makeTask(pool, "second", true);
+    queue.push(first);
+    queue.push(second);
+    struct iovec iov[8];
+    int file_fd;
+    off_t file_offset;
+    size_t file_length;
+    /*
+     * После заголовка ответа с файлом заполнение останавливается, дальше отправляется файл
+     */
+    ASSERT_FALSE(queue.fillFile(file_fd, file_offset, file_length));
+    ASSERT_EQ(collect(iov, queue.fill(iov, 8)), first->getResponseHeader());
+    std::vector<onyxup::PtrTask> released;
+    auto release = [&released](onyxup::PtrTask task) { released.push_back(task); };
+    queue.consume(first->getResponseHeader().size() + 1, release);
+    ASSERT_TRUE(queue.fillFile(file_fd, file_offset, file_length));
+    ASSERT_EQ(file_fd, first->getResponseFile().file->getFD());
+    ASSERT_EQ(file_offset, 3);
+    ASSERT_EQ(file_length, 5);
+    queue.consume(file_length, release);
+    ASSERT_EQ(released.size(), 1);
+    ASSERT_FALSE(queue.fillFile(file_fd, file_offset, file_length));
+    ASSERT_EQ(collect(iov, queue.fill(iov, 8)), second->getResponseHeader() + "second");
+    queue.consume(second->getResponseLength(), release);
+    ASSERT_TRUE(queue.empty());
+    for (auto task : released)
+        pool.release(task);
+}
+
+TEST_F(ResponseQueueTests, Test_4) {
+    char path[] = "/tmp/onyxup-queue-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_EQ(write(fd, "0123456789", 10), 10);
+    close(fd);
+    onyxup::TaskPool pool(4);
+    onyxup::ResponseQueue queue;
+    onyxup::PtrTask first = pool.acquire();
+    onyxup::ResponseBase response(200, "OK", "text/plain");
+    response.setFile(onyxup::StaticFile::open(path, 1024));
+    response.setFileRange(2, 6);
+    first->setResponse(response);
+    first->setPerformed(true);
+    unlink(path);
+    onyxup::PtrTask second = makeTask(pool, "second", true);
+    queue.push(first);
+    queue.push(second);
+    struct iovec iov[8];
+    int file_fd;
+    off_t file_offset;
+    size_t file_length;
+    /*
+     * Отображенный файл отправляется вместе с остальными ответами через iov
+     */
+    std::string expected = first->getResponseHeader() + "234567" + second->getResponseHeader() + "second";
+    ASSERT_FALSE(queue.fillFile(file_fd, file_offset, file_length));
+    ASSERT_EQ(collect(iov, queue.fill(iov, 8)), expected);
+    std::vector<onyxup::PtrTask> released;
+    auto release = [&released](onyxup::PtrTask task) { released.push_back(task); };
+    size_t offset = first->getResponseHeader().size() + 2;
+    queue.consume(offset, release);
+    ASSERT_EQ(collect(iov, queue.fill(iov, 8)), expected.substr(offset));
+    queue.consume(expected.size() - offset, release);
+    ASSERT_EQ(released.size(), 2);
+    ASSERT_TRUE(queue.empty());
+    for (auto task : released)
+        pool.release(task);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../sources/response/response-writer.h"
+#include "../sources/response/response-states.h"
+
+class ResponseWriterTests : public ::testing::Test {
+
+public:
+
+    ResponseWriterTests() {
+    }
+
+    ~ResponseWriterTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+static std::string contentLength(const std::string &response) {
+    size_t pos = response.find("\r\nContent-Length:");
+    size_t end = response.find("\r\n", pos + 2);
+    std::string value = response.substr(pos + 17, end - pos - 17);
+    return value.substr(value.find_first_not_of(' '));
+}
+
+TEST_F(ResponseWriterTests, Test_1) {
+    std::string out;
+    onyxup::ResponseWriter writer(out);
+    writer.status(onyxup::ResponseState::RESPONSE_STATE_CREATED_CODE, onyxup::ResponseState::RESPONSE_STATE_CREATED_MSG);
+    writer.header("Content-Type", "application/json");
+    writer.write("{\"id\":");
+    writer.write("42}");
+    writer.finish();
+    ASSERT_EQ(writer.getCode(), 201);
+    ASSERT_EQ(out.compare(0, 22, "HTTP/1.1 201 Created\r\n"), 0);
+    ASSERT_NE(out.find("\r\nContent-Type: application/json\r\n"), std::string::npos);
+    ASSERT_EQ(contentLength(out), "9");
+    size_t body = out.find("\r\n\r\n");
+    ASSERT_EQ(out.substr(body + 4), "{\"id\":42}");
+    /*
+     * Поле Content-Length фиксированной ширины
+     */
+    ASSERT_EQ(out.find("\r\n", out.find("Content-Length:")) - out.find("Content-Length:"),
+              15 + onyxup::ResponseWriter::CONTENT_LENGTH_WIDTH);
+}
+
+TEST_F(ResponseWriterTests, Test_2) {
+    /*
+     * Без status - 200 OK, HEAD - тело учитывается, но не пишется
+     */
+    std::string out = "old data";
+    onyxup::ResponseWriter writer(out, true);
+    writer.write("hello");
+    writer.finish();
+    ASSERT_EQ(out.compare(0, 17, "HTTP/1.1 200 OK\r\n"), 0);
+    ASSERT_EQ(contentLength(out), "5");
+    ASSERT_EQ(out.compare(out.size() - 4, 4, "\r\n\r\n"), 0);
+    ASSERT_EQ(writer.getBodyLength(), 5);
+}
+
+TEST_F(ResponseWriterTests, Test_3) {
+    std::string out;
+    onyxup::ResponseWriter writer(out);
+    writer.header("content-length", "3");
+    writer.write("abc");
+    writer.finish();
+    ASSERT_NE(out.find("\r\ncontent-length: 3\r\n\r\nabc"), std::string::npos);
+    ASSERT_EQ(out.find("Content-Length:"), std::string::npos);
+    ASSERT_THROW(writer.header("X-Late", "1"), onyxup::OnyxupException);
+    std::string empty;
+    onyxup::ResponseWriter empty_writer(empty);
+    empty_writer.finish();
+    ASSERT_EQ(contentLength(empty), "0");
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <functional>
+
+#include "../sources/route/router.h"
+
+class RouterTests : public ::testing::Test {
+
+public:
+
+    RouterTests() {
+    }
+
+    ~RouterTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+    /*
+     * Обработчик возвращает код, по которому тест узнает сработавший маршрут
+     */
+    static std::function<onyxup::ResponseBase(onyxup::PtrCRequest)> handler(int id) {
+        return [id](onyxup::PtrCRequest) -> onyxup::ResponseBase {
+            return onyxup::ResponseBase(id, "OK", "text/plain", std::string());
+        };
+    }
+
+    static int match(const onyxup::Router &router, const std::string &method, const std::string &uri,
+                     onyxup::PtrRequest request = nullptr) {
+        const onyxup::Route *route = router.match(method, uri, request);
+        if (route == nullptr)
+            return -1;
+        return route->getHandler()(request).getCode();
+    }
+
+    void addRegex(onyxup::Router &router, const std::string &method, const char *regex, int id) {
+        auto h = handler(id);
+        router.addRegexRoute(method, regex, h, onyxup::EnumTaskType::LOCAL_TASK);
+    }
+
+    void addPath(onyxup::Router &router, const std::string &method, const std::string &path, int id) {
+        auto h = handler(id);
+        router.addPathRoute(method, path, h, onyxup::EnumTaskType::LOCAL_TASK);
+    }
+};
+
+TEST_F(RouterTests, Test_1) {
+    onyxup::Router router;
+    addRegex(router, "GET", "^/test$", 1);
+    addRegex(router, "GET", "^/test-2$", 2);
+    addRegex(router, "GET", "^/static/.+$", 3);
+    addRegex(router, "GET", "^/json", 4);
+    addRegex(router, "POST", "^/test$", 5);
+    ASSERT_EQ(match(router, "GET", "/test"), 1);
+    ASSERT_EQ(match(router, "GET", "/test-2"), 2);
+    ASSERT_EQ(match(router, "GET", "/test?a=1"), -1);
+    ASSERT_EQ(match(router, "GET", "/test-"), -1);
+    ASSERT_EQ(match(router, "GET", "/static/a.css"), 3);
+    ASSERT_EQ(match(router, "GET", "/static/"), -1);
+    ASSERT_EQ(match(router, "GET", "/json"), 4);
+    ASSERT_EQ(match(router, "GET", "/json?x=1"), 4);
+    ASSERT_EQ(match(router, "POST", "/test"), 5);
+    ASSERT_EQ(match(router, "PUT", "/test"), -1);
+}
+
+TEST_F(RouterTests, Test_2) {
+    /*
+     * Из подходящих маршрутов побеждает добавленный раньше
+     */
+    onyxup::Router router;
+    addRegex(router, "GET", "^/api", 1);
+    addRegex(router, "GET", "^/api/users$", 2);
+    addRegex(router, "GET", "^/files/[0-9]+$", 3);
+    addRegex(router, "GET", "^/files/.+$", 4);
+    addRegex(router, "GET", "^/files/abc$", 5);
+    addRegex(router, "GET", "\\.png$", 6);
+    ASSERT_EQ(match(router, "GET", "/api/users"), 1);
+    ASSERT_EQ(match(router, "GET", "/files/123"), 3);
+    ASSERT_EQ(match(router, "GET", "/files/abc"), 4);
+    ASSERT_EQ(match(router, "GET", "/img/a.png"), 6);
+    ASSERT_EQ(match(router, "GET", "/img/a.jpg"), -1);
+}
+
+TEST_F(RouterTests, Test_3) {
+    onyxup::Router router;
+    addPath(router, "GET", "/users/{id:int}", 1);
+    addPath(router, "GET", "/users/{name}", 2);
+    addPath(router, "GET", "/users/{id:int}/posts/{slug:str}", 3);
+    addPath(router, "GET", "/users/me", 4);
+    onyxup::PtrRequest request = onyxup::req::requestFactory();
+    ASSERT_EQ(match(router, "GET", "/users/42", request), 1);
+    ASSERT_EQ(request->getPathParams().at("id"), "42");
+    request->clear();
+    ASSERT_EQ(match(router, "GET", "/users/bob?x=1", request), 2);
+    ASSERT_EQ(request->getPathParams().at("name"), "bob");
+    request->clear();
+    ASSERT_EQ(match(router, "GET", "/users/-7/posts/hello", request), 3);
+    ASSERT_EQ(request->getPathParams().at("id"), "-7");
+    ASSERT_EQ(request->getPathParams().at("slug"), "hello");
+    request->clear();
+    ASSERT_EQ(match(router, "GET", "/users/me", request), 2);
+    ASSERT_EQ(match(router, "GET", "/users/", request), -1);
+    ASSERT_EQ(match(router, "GET", "/users/42/posts", request), -1);
+    ASSERT_EQ(match(router, "GET", "/users/42/posts/a/b", request), -1);
+    delete request;
+}
+
+TEST_F(RouterTests, Test_4) {
+    onyxup::Router router;
+    ASSERT_THROW(addPath(router, "GET", "users", 1), onyxup::OnyxupException);
+    ASSERT_THROW(addPath(router, "GET", "/users/{id:float}", 1), onyxup::OnyxupException);
+    ASSERT_THROW(addPath(router, "GET", "/users/{id", 1), onyxup::OnyxupException);
+    ASSERT_THROW(addPath(router, "GET", "/users/{id}.json", 1), onyxup::OnyxupException);
+    ASSERT_THROW(addPath(router, "GET", "/users/{}", 1), onyxup::OnyxupException);
+    ASSERT_EQ(router.size(), 0);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
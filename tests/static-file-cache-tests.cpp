@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "../sources/static/static-file-cache.h"
+#include "../sources/response/response-base.h"
+#include "../sources/response/http-date.h"
+#include "../sources/gzip/compress.hpp"
+#include "../sources/gzip/decompress.hpp"
+
+class StaticFileCacheTests : public ::testing::Test {
+
+public:
+
+    std::string directory;
+
+    StaticFileCacheTests() {
+    }
+
+    ~StaticFileCacheTests() {
+    }
+
+    void SetUp() {
+        char path[] = "/tmp/onyxup-static-XXXXXX";
+        directory = mkdtemp(path);
+        std::ofstream(directory + "/a.txt") << "0123456789";
+        std::ofstream(directory + "/b.txt") << "abc";
+        std::ofstream(directory + "/c.txt") << "def";
+    }
+
+    void TearDown() {
+        unlink((directory + "/a.txt").c_str());
+        unlink((directory + "/b.txt").c_str());
+        unlink((directory + "/c.txt").c_str());
+        unlink((directory + "/c.txt.gz").c_str());
+        rmdir(directory.c_str());
+    }
+
+};
+
+TEST_F(StaticFileCacheTests, Test_1) {
+    onyxup::StaticFileCache cache;
+    onyxup::PtrStaticFile file = cache.get(directory + "/a.txt");
+    ASSERT_NE(file, nullptr);
+    ASSERT_EQ(file->getSize(), 10);
+    /*
+     * ETag начинается с размера файла в шестнадцатеричном виде
+     */
+    ASSERT_EQ(file->getETag().compare(0, 3, "\"a-"), 0);
+    ASSERT_EQ(file->getETag().back(), '"');
+    ASSERT_EQ(file->getLastModified().size(), onyxup::HttpDate::LENGTH);
+    /*
+     * Повторное обращение возвращает тот же открытый файл
+     */
+    ASSERT_EQ(cache.get(directory + "/a.txt"), file);
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_EQ(cache.get(directory + "/none.txt"), nullptr);
+    /*
+     * Каталог не является статическим ресурсом
+     */
+    ASSERT_EQ(cache.get(directory), nullptr);
+    ASSERT_EQ(cache.size(), 1);
+}
+
+TEST_F(StaticFileCacheTests, Test_2) {
+    onyxup::StaticFileCache cache(15);
+    onyxup::PtrStaticFile a = cache.get(directory + "/a.txt");
+    onyxup::PtrStaticFile b = cache.get(directory + "/b.txt");
+    ASSERT_TRUE(a->isInMemory());
+    ASSERT_EQ(cache.getCurrentSize(), 13);
+    /*
+     * Последним запрошен a.txt, поэтому при добавлении c.txt вытесняется b.txt
+     */
+    ASSERT_EQ(cache.get(directory + "/a.txt"), a);
+    onyxup::PtrStaticFile c = cache.get(directory + "/c.txt");
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.getCurrentSize(), 13);
+    ASSERT_EQ(cache.get(directory + "/a.txt"), a);
+    ASSERT_EQ(cache.get(directory + "/c.txt"), c);
+    /*
+     * Вытесненный файл остается доступным, пока на него есть ссылки
+     */
+    std::string data;
+    ASSERT_TRUE(b->read(0, 3, data));
+    ASSERT_EQ(data, "abc");
+    ASSERT_TRUE(a->read(2, 5, data));
+    ASSERT_EQ(data, "23456");
+    /*
+     * Файл больше ограничения не отображается и не кешируется
+     */
+    cache.setMaxSize(5);
+    ASSERT_EQ(cache.size(), 1);
+    onyxup::PtrStaticFile big = cache.get(directory + "/a.txt");
+    ASSERT_FALSE(big->isInMemory());
+    ASSERT_NE(cache.get(directory + "/a.txt"), big);
+    ASSERT_EQ(cache.getCurrentSize(), 3);
+    ASSERT_TRUE(big->read(8, 2, data));
+    ASSERT_EQ(data, "89");
+    ASSERT_FALSE(big->read(8, 5, data));
+    ASSERT_EQ(data, "89");
+}
+
+TEST_F(StaticFileCacheTests, Test_3) {
+    onyxup::ResponseBase response(200, "OK", "text/plain");
+    response.setFile(onyxup::StaticFile::open(directory + "/a.txt"));
+    ASSERT_EQ(response.getContentLength(), 10);
+    ASSERT_TRUE(response.getBody().empty());
+    response.setFileRange(3, 4);
+    ASSERT_EQ(response.getContentLength(), 4);
+    /*
+     * Для работы с телом как со строкой файл читается в память
+     */
+    response.loadFile();
+    ASSERT_EQ(response.getBody(), "3456");
+    ASSERT_EQ(response.getFile().file, nullptr);
+    ASSERT_EQ(response.getContentLength(), 4);
+}
+
+TEST_F(StaticFileCacheTests, Test_4) {
+    onyxup::StaticFileCache cache;
+    onyxup::PtrStaticFile a = cache.get(directory + "/a.txt");
+    onyxup::PtrStaticFile compressed = cache.getCompressed(directory + "/a.txt", a);
+    ASSERT_NE(compressed, nullptr);
+    ASSERT_TRUE(compressed->isInMemory());
+    ASSERT_EQ(gzip::decompress(compressed->getData(), compressed->getSize()), "0123456789");
+    ASSERT_EQ(compressed->getETag(), onyxup::StaticFile::variantETag(a->getETag(), "gzip"));
+    ASSERT_EQ(compressed->getLastModified(), a->getLastModified());
+    /*
+     * Вариант сжимается один раз и хранится в кеше рядом с файлом
+     */
+    ASSERT_EQ(cache.getCompressed(directory + "/a.txt", a), compressed);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(cache.getCurrentSize(), 10 + compressed->getSize());
+    /*
+     * Готовый файл .gz используется вместо сжатия
+     */
+    std::ofstream(directory + "/c.txt.gz") << "sidecar";
+    onyxup::PtrStaticFile c = cache.get(directory + "/c.txt");
+    onyxup::PtrStaticFile sidecar = cache.getCompressed(directory + "/c.txt", c);
+    ASSERT_EQ(std::string(sidecar->getData(), sidecar->getSize()), "sidecar");
+    ASSERT_EQ(cache.getCompressed(directory + "/c.txt", c), sidecar);
+}
+
+TEST_F(StaticFileCacheTests, Test_5) {
+    onyxup::StaticFileCache cache;
+    onyxup::PtrStaticFile a = cache.get(directory + "/a.txt");
+    onyxup::PtrStaticFile compressed = cache.getCompressed(directory + "/a.txt", a);
+    cache.get(directory + "/b.txt");
+    std::ofstream(directory + "/a.txt.new") << "changed";
+    ASSERT_EQ(rename((directory + "/a.txt.new").c_str(), (directory + "/a.txt").c_str()), 0);
+    /*
+     * Файл и его сжатый вариант перечитываются сразу, кеш остается прогретым
+     */
+    cache.refresh(directory + "/a.txt");
+    ASSERT_EQ(cache.size(), 3);
+    onyxup::PtrStaticFile changed = cache.get(directory + "/a.txt");
+    ASSERT_NE(changed, a);
+    ASSERT_EQ(std::string(changed->getData(), changed->getSize()), "changed");
+    ASSERT_NE(cache.getCompressed(directory + "/a.txt", changed), compressed);
+    ASSERT_EQ(cache.size(), 3);
+    /*
+     * Исчезнувшие файлы удаляются
+     */
+    unlink((directory + "/a.txt").c_str());
+    unlink((directory + "/b.txt").c_str());
+    cache.refreshPrefix(directory + "/");
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.getCurrentSize(), 0);
+}
+
+TEST_F(StaticFileCacheTests, Test_6) {
+    /*
+     * Отображенный файл усекли на месте: чтение и сжатие возвращают ошибку, процесс не падает по SIGBUS
+     */
+    std::string path = directory + "/d.txt";
+    std::ofstream(path) << std::string(64 * 1024, 'd');
+    onyxup::PtrStaticFile file = onyxup::StaticFile::open(path, 1024 * 1024);
+    ASSERT_NE(file, nullptr);
+    ASSERT_TRUE(file->isInMemory());
+    std::string out;
+    ASSERT_TRUE(file->read(0, 16, out));
+    ASSERT_EQ(out, std::string(16, 'd'));
+    ASSERT_EQ(truncate(path.c_str(), 0), 0);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_FALSE(file->read(32 * 1024, 1024, out));
+        ASSERT_EQ(onyxup::StaticFile::compress(*file), nullptr);
+    }
+    unlink(path.c_str());
+}
+
+TEST_F(StaticFileCacheTests, Test_7) {
+    /*
+     * Разные записи одного URI дают один ключ и одну запись кеша, ".." за пределы каталога не пускает
+     */
+    const char *aliases[] = {"/a.txt", "//a.txt", "/./a.txt", "/.//./a.txt", "/b/../a.txt"};
+    std::string key;
+    ASSERT_TRUE(onyxup::StaticFileCache::makeKey(directory, aliases[0], key));
+    ASSERT_EQ(key, directory + "/a.txt");
+    onyxup::StaticFileCache cache;
+    for (size_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(onyxup::StaticFileCache::makeKey(directory, aliases[i], key)) << aliases[i];
+        ASSERT_EQ(key, directory + "/a.txt") << aliases[i];
+        ASSERT_NE(cache.get(key), nullptr);
+    }
+    ASSERT_EQ(cache.size(), 1);
+    ASSERT_FALSE(onyxup::StaticFileCache::makeKey(directory, aliases[4], key));
+    ASSERT_FALSE(onyxup::StaticFileCache::makeKey(directory, "/../etc/passwd", key));
+    ASSERT_FALSE(onyxup::StaticFileCache::makeKey(directory, "/static/..", key));
+    ASSERT_TRUE(onyxup::StaticFileCache::makeKey(directory, "/static//js/./app.js", key));
+    ASSERT_EQ(key, directory + "/static/js/app.js");
+    ASSERT_TRUE(onyxup::StaticFileCache::makeKey(directory, "/..a/b../.c", key));
+    ASSERT_EQ(key, directory + "/..a/b../.c");
+    ASSERT_TRUE(onyxup::StaticFileCache::makeKey(directory, "/static/", key));
+    ASSERT_EQ(key, directory + "/static/");
+}
+
+TEST_F(StaticFileCacheTests, Test_8) {
+    /*
+     * Вариант для кеша сжимается с максимальной степенью, без кеша - с обычной
+     */
+    std::string data;
+    for (int i = 0; i < 4096; i++)
+        data += "line " + std::to_string(i % 97) + " of static content\n";
+    std::string path = directory + "/e.txt";
+    std::ofstream(path) << data;
+    onyxup::StaticFileCache cache;
+    onyxup::PtrStaticFile file = cache.get(path);
+    ASSERT_NE(file, nullptr);
+    onyxup::PtrStaticFile cached = cache.getCompressed(path, file);
+    onyxup::PtrStaticFile uncached = onyxup::StaticFile::openCompressed(path, *file);
+    ASSERT_NE(cached, nullptr);
+    ASSERT_NE(uncached, nullptr);
+    ASSERT_EQ(std::string(cached->getData(), cached->getSize()), gzip::compress(data.data(), data.size(), Z_BEST_COMPRESSION));
+    ASSERT_EQ(std::string(uncached->getData(), uncached->getSize()), gzip::compress(data.data(), data.size(), Z_DEFAULT_COMPRESSION));
+    ASSERT_EQ(gzip::decompress(uncached->getData(), uncached->getSize()), data);
+    unlink(path.c_str());
+}
+
+TEST_F(StaticFileCacheTests, Test_9) {
+    /*
+     * Файл заменяют, пока другой поток его открывает, и обновление кеша выполняется до вставки
+     * открытого раньше файла: старое содержимое не должно остаться в кеше. Старый файл разреженный -
+     * отображение его страниц занимает миллисекунды, за которые успевают rename и refresh
+     */
+    std::string path = directory + "/f.txt";
+    std::string tmp = directory + "/f.txt.tmp";
+    for (int i = 0; i < 10; i++) {
+        std::ofstream(path).close();
+        ASSERT_EQ(truncate(path.c_str(), 16 * 1024 * 1024), 0);
+        std::ofstream(tmp) << "new";
+        onyxup::StaticFileCache cache;
+        std::thread reader([&cache, &path]() {
+            cache.get(path);
+        });
+        std::this_thread::sleep_for(std::chrono::microseconds(200 * (i + 1)));
+        ASSERT_EQ(rename(tmp.c_str(), path.c_str()), 0);
+        cache.refresh(path);
+        reader.join();
+        onyxup::PtrStaticFile file = cache.get(path);
+        ASSERT_NE(file, nullptr);
+        ASSERT_EQ(std::string(file->getData(), file->getSize()), "new") << "итерация " << i;
+    }
+    unlink(path.c_str());
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "../sources/static/static-file-watcher.h"
+
+class StaticFileWatcherTests : public ::testing::Test {
+
+public:
+
+    std::string directory;
+
+    StaticFileWatcherTests() {
+    }
+
+    ~StaticFileWatcherTests() {
+    }
+
+    void SetUp() {
+        char path[] = "/tmp/onyxup-watch-XXXXXX";
+        directory = mkdtemp(path);
+        mkdir((directory + "/static").c_str(), 0755);
+        std::ofstream(directory + "/static/a.txt") << "first";
+    }
+
+    void TearDown() {
+        std::string command = "rm -rf " + directory;
+        ASSERT_EQ(system(command.c_str()), 0);
+    }
+
+    /*
+     * Файл заменяется так же, как при выкладке: запись во временный файл и rename
+     */
+    void replace(const std::string & name, const std::string & data) {
+        std::ofstream(directory + name + ".tmp") << data;
+        ASSERT_EQ(rename((directory + name + ".tmp").c_str(), (directory + name).c_str()), 0);
+    }
+
+    static std::string content(const onyxup::PtrStaticFile & file) {
+        return std::string(file->getData(), file->getSize());
+    }
+
+    /*
+     * Обновление кеша асинхронное - ждем его не дольше двух секунд
+     */
+    static bool waitContent(onyxup::StaticFileCache & cache, const std::string & path, const std::string & expected) {
+        for (int i = 0; i < 200; i++) {
+            onyxup::PtrStaticFile file = cache.get(path);
+            if (file != nullptr && content(file) == expected)
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+};
+
+TEST_F(StaticFileWatcherTests, Test_1) {
+    onyxup::StaticFileCache cache;
+    std::string path = directory + "/static/a.txt";
+    ASSERT_EQ(content(cache.get(path)), "first");
+    onyxup::StaticFileWatcher watcher(cache, directory);
+    ASSERT_TRUE(watcher.start());
+    replace("/static/a.txt", "second");
+    ASSERT_TRUE(waitContent(cache, path, "second"));
+    /*
+     * Удаленный файл вытесняется из кеша
+     */
+    unlink(path.c_str());
+    for (int i = 0; i < 200 && cache.size() > 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.get(path), nullptr);
+}
+
+TEST_F(StaticFileWatcherTests, Test_2) {
+    onyxup::StaticFileCache cache;
+    onyxup::StaticFileWatcher watcher(cache, directory + "/");
+    ASSERT_TRUE(watcher.start());
+    /*
+     * За новым подкаталогом тоже следим. Путь строится как root + URI, с двойной косой чертой
+     */
+    mkdir((directory + "/static/js").c_str(), 0755);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::ofstream(directory + "/static/js/b.js") << "first";
+    std::string path = directory + "//static/js/b.js";
+    ASSERT_EQ(content(cache.get(path)), "first");
+    replace("/static/js/b.js", "second");
+    ASSERT_TRUE(waitContent(cache, path, "second"));
+}
+
+TEST_F(StaticFileWatcherTests, Test_3) {
+    onyxup::StaticFileCache cache;
+    std::string release = directory + "/release";
+    mkdir(release.c_str(), 0755);
+    std::ofstream(release + "/a.txt") << "first";
+    std::string current = directory + "/current";
+    ASSERT_EQ(symlink(release.c_str(), current.c_str()), 0);
+    std::string path = current + "/a.txt";
+    ASSERT_EQ(content(cache.get(path)), "first");
+    onyxup::StaticFileWatcher watcher(cache, current);
+    ASSERT_TRUE(watcher.start());
+    /*
+     * Выкладка заменой ссылки на каталог целиком
+     */
+    std::string next = directory + "/next";
+    mkdir(next.c_str(), 0755);
+    std::ofstream(next + "/a.txt") << "second";
+    ASSERT_EQ(symlink(next.c_str(), (current + ".tmp").c_str()), 0);
+    ASSERT_EQ(rename((current + ".tmp").c_str(), current.c_str()), 0);
+    ASSERT_TRUE(waitContent(cache, path, "second"));
+    /*
+     * Наблюдение перенесено на новый каталог
+     */
+    replace("/next/a.txt", "third");
+    ASSERT_TRUE(waitContent(cache, path, "third"));
+}
+
+TEST_F(StaticFileWatcherTests, Test_4) {
+    /*
+     * Запись, полученная по URI с лишними "/" и ".", обновляется вместе с файлом: ключ кеша
+     * строится одинаково в обработчике запросов и в наблюдателе
+     */
+    onyxup::StaticFileCache cache;
+    std::string path;
+    ASSERT_TRUE(onyxup::StaticFileCache::makeKey(directory, "//static/./a.txt", path));
+    ASSERT_EQ(content(cache.get(path)), "first");
+    onyxup::StaticFileWatcher watcher(cache, directory);
+    ASSERT_TRUE(watcher.start());
+    replace("/static/a.txt", "second");
+    ASSERT_TRUE(waitContent(cache, path, "second"));
+    ASSERT_EQ(cache.size(), 1);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
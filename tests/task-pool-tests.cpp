@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string.h>
+
+#include "../sources/task/task-pool.h"
+
+class TaskPoolTests : public ::testing::Test {
+
+public:
+
+    TaskPoolTests() {
+    }
+
+    ~TaskPoolTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(TaskPoolTests, Test_1) {
+    onyxup::TaskPool pool(2);
+    onyxup::PtrTask task = pool.acquire();
+    ASSERT_NE(task, nullptr);
+    ASSERT_NE(task->getRequest(), nullptr);
+    const char *uri = "/test";
+    task->getRequest()->setFullURI(uri, strlen(uri));
+    task->setPerformed(true);
+    onyxup::ResponseBase response(200, "OK", "text/plain", std::string("body"));
+    task->setResponse(response);
+    ASSERT_EQ(task->getResponseBody(), "body");
+    ASSERT_EQ(task->getResponseHeader().compare(0, 15, "HTTP/1.1 200 OK"), 0);
+    pool.release(task);
+    ASSERT_EQ(pool.size(), 1);
+    /*
+     * Задача возвращается из пула очищенной вместе с запросом
+     */
+    onyxup::PtrTask reused = pool.acquire();
+    ASSERT_EQ(reused, task);
+    ASSERT_EQ(pool.size(), 0);
+    ASSERT_FALSE(reused->isPerformed());
+    ASSERT_TRUE(reused->getResponseHeader().empty());
+    ASSERT_TRUE(reused->getResponseBody().empty());
+    ASSERT_TRUE(reused->getRequest()->getFullURIRef().empty());
+    ASSERT_EQ(reused->getNext(), nullptr);
+    pool.release(reused);
+}
+
+TEST_F(TaskPoolTests, Test_2) {
+    onyxup::TaskPool pool(2);
+    onyxup::PtrTask tasks[4];
+    for (auto &task : tasks)
+        task = pool.acquire();
+    for (auto &task : tasks)
+        pool.release(task);
+    /*
+     * Сверх лимита задачи удаляются
+     */
+    ASSERT_EQ(pool.size(), 2);
+    onyxup::PtrTask first = pool.acquire();
+    onyxup::PtrTask second = pool.acquire();
+    ASSERT_EQ(first, tasks[1]);
+    ASSERT_EQ(second, tasks[0]);
+    pool.release(first);
+    pool.release(second);
+}
+
+TEST_F(TaskPoolTests, Test_3) {
+    /*
+     * Задача, через которую прошли большой запрос и большой ответ, возвращается в пул
+     * без их памяти, небольшие буферы сохраняются
+     */
+    onyxup::TaskPool pool(2);
+    onyxup::PtrTask task = pool.acquire();
+    std::string body(2 * 1024 * 1024, 'b');
+    ASSERT_TRUE(task->getRequest()->setBody(body.data(), body.size()));
+    ASSERT_GE(task->getRequest()->getStorageCapacity(), body.size());
+    onyxup::ResponseBase response(200, "OK", "text/plain", body);
+    task->setResponse(response);
+    std::string &buffer = task->getResponseBuffer();
+    buffer.assign(body);
+    pool.release(task);
+    onyxup::PtrTask reused = pool.acquire();
+    ASSERT_EQ(reused, task);
+    ASSERT_LE(reused->getRequest()->getStorageCapacity(), onyxup::Task::MAX_RETAINED_BUFFER_LENGTH);
+    ASSERT_LE(reused->getResponseHeader().capacity(), onyxup::Task::MAX_RETAINED_BUFFER_LENGTH);
+    ASSERT_LE(reused->getResponseBody().capacity(), onyxup::Task::MAX_RETAINED_BUFFER_LENGTH);
+    std::string small(1024, 's');
+    ASSERT_TRUE(reused->getRequest()->setBody(small.data(), small.size()));
+    size_t capacity = reused->getRequest()->getStorageCapacity();
+    pool.release(reused);
+    reused = pool.acquire();
+    ASSERT_EQ(reused->getRequest()->getStorageCapacity(), capacity);
+    pool.release(reused);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "../sources/scheduler/task-scheduler.h"
+
+class TaskSchedulerTests : public ::testing::Test {
+
+public:
+
+    TaskSchedulerTests() {
+    }
+
+    ~TaskSchedulerTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+    static onyxup::PtrTask createTask(onyxup::EnumTaskType type, int fd) {
+        onyxup::PtrTask task = onyxup::taskFactory();
+        task->setType(type);
+        task->setFD(fd);
+        return task;
+    }
+
+};
+
+TEST_F(TaskSchedulerTests, Test_1) {
+    /*
+     * Задачи раскладываются по всем воркерам, один воркер забирает их все
+     */
+    onyxup::TaskScheduler scheduler(4);
+    for (int i = 0; i < 8; i++)
+        ASSERT_TRUE(scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, i)));
+    ASSERT_EQ(scheduler.size(onyxup::EnumTaskType::LOCAL_TASK), 8);
+    ASSERT_EQ(scheduler.size(onyxup::EnumTaskType::STATIC_RESOURCES_TASK), 0);
+    std::vector<bool> seen(8, false);
+    for (int i = 0; i < 8; i++) {
+        onyxup::PtrTask task = scheduler.pop(0);
+        seen[task->getFD()] = true;
+        delete task;
+    }
+    for (bool s : seen)
+        ASSERT_TRUE(s);
+    ASSERT_EQ(scheduler.size(), 0);
+}
+TEST_F(TaskSchedulerTests, Test_2) {
+    /*
+     * Статические задачи выбираются раньше локальных
+     */
+    onyxup::TaskScheduler scheduler(2);
+    scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, 1));
+    scheduler.push(createTask(onyxup::EnumTaskType::STATIC_RESOURCES_TASK, 2));
+    onyxup::PtrTask task = scheduler.pop(1);
+    ASSERT_EQ(task->getType(), onyxup::EnumTaskType::STATIC_RESOURCES_TASK);
+    delete task;
+    task = scheduler.pop(1);
+    ASSERT_EQ(task->getType(), onyxup::EnumTaskType::LOCAL_TASK);
+    delete task;
+}
+TEST_F(TaskSchedulerTests, Test_3) {
+    /*
+     * Поток статических задач не вытесняет локальные
+     */
+    onyxup::TaskScheduler scheduler(1);
+    for (int i = 0; i < 32; i++)
+        scheduler.push(createTask(onyxup::EnumTaskType::STATIC_RESOURCES_TASK, i));
+    scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, 100));
+    bool local = false;
+    for (int i = 0; i < 16; i++) {
+        onyxup::PtrTask task = scheduler.pop(0);
+        local = local || task->getType() == onyxup::EnumTaskType::LOCAL_TASK;
+        delete task;
+    }
+    ASSERT_TRUE(local);
+}
+TEST_F(TaskSchedulerTests, Test_4) {
+    /*
+     * Спящие воркеры просыпаются и разбирают все задачи
+     */
+    const int workers = 4, count = 20000;
+    onyxup::TaskScheduler scheduler(workers);
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++)
+        threads.emplace_back([&scheduler, &received, i] {
+            for (;;) {
+                onyxup::PtrTask task = scheduler.pop(i);
+                bool stop = task->getFD() < 0;
+                delete task;
+                if (stop)
+                    return;
+                received++;
+            }
+        });
+    for (int i = 0; i < count; i++)
+        while (!scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, i)))
+            std::this_thread::yield();
+    while (received.load() < count)
+        std::this_thread::yield();
+    for (int i = 0; i < workers; i++)
+        scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, -1));
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(received.load(), count);
+}
+
+TEST_F(TaskSchedulerTests, Test_5) {
+    /*
+     * Все воркеры засыпают между пачками задач, следующая пачка все равно разбирается
+     */
+    const int workers = 4, rounds = 50, batch = 64;
+    onyxup::TaskScheduler scheduler(workers);
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++)
+        threads.emplace_back([&scheduler, &received, i] {
+            for (;;) {
+                onyxup::PtrTask task = scheduler.pop(i);
+                bool stop = task->getFD() < 0;
+                delete task;
+                if (stop)
+                    return;
+                received++;
+            }
+        });
+    bool stalled = false;
+    for (int round = 1; round <= rounds && !stalled; round++) {
+        /*
+         * Пауза, за которую воркеры успевают заснуть на futex
+         */
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        for (int i = 0; i < batch; i++)
+            ASSERT_TRUE(scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, i)));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (received.load() < round * batch && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        stalled = received.load() < round * batch;
+    }
+    if (stalled) {
+        for (auto &thread : threads)
+            thread.detach();
+        FAIL() << "Задачи остались в очереди: " << scheduler.size();
+    }
+    for (int i = 0; i < workers; i++)
+        scheduler.push(createTask(onyxup::EnumTaskType::LOCAL_TASK, -1));
+    for (auto &thread : threads)
+        thread.join();
+    ASSERT_EQ(received.load(), rounds * batch);
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+
+#include "../sources/timer/timer-wheel.h"
+
+using namespace std::chrono_literals;
+
+class TimerWheelTests : public ::testing::Test {
+
+public:
+
+    TimerWheelTests() {
+    }
+
+    ~TimerWheelTests() {
+    }
+
+    void SetUp() {
+
+    }
+
+    void TearDown() {
+    }
+
+};
+
+TEST_F(TimerWheelTests, Test_1) {
+    onyxup::TimerWheel wheel(10, 100ms, 16);
+    auto now = onyxup::TimerWheel::Clock::now();
+    std::vector<int> expired;
+    wheel.arm(3, now + 250ms);
+    wheel.arm(5, now + 1s);
+    ASSERT_EQ(wheel.size(), 2);
+    wheel.expire(now + 200ms, expired);
+    ASSERT_EQ(expired.size(), 0);
+    wheel.expire(now + 400ms, expired);
+    ASSERT_EQ(expired.size(), 1);
+    ASSERT_EQ(expired[0], 3);
+    ASSERT_FALSE(wheel.isArmed(3));
+    ASSERT_TRUE(wheel.isArmed(5));
+}
+TEST_F(TimerWheelTests, Test_2) {
+    onyxup::TimerWheel wheel(10, 100ms, 16);
+    auto now = onyxup::TimerWheel::Clock::now();
+    std::vector<int> expired;
+    wheel.arm(1, now + 300ms);
+    wheel.arm(2, now + 300ms);
+    wheel.cancel(1);
+    wheel.arm(2, now + 900ms);
+    wheel.expire(now + 500ms, expired);
+    ASSERT_EQ(expired.size(), 0);
+    ASSERT_EQ(wheel.size(), 1);
+    wheel.expire(now + 1s, expired);
+    ASSERT_EQ(expired.size(), 1);
+    ASSERT_EQ(expired[0], 2);
+    ASSERT_EQ(wheel.size(), 0);
+}
+TEST_F(TimerWheelTests, Test_3) {
+    /*
+     * Дедлайн дальше одного оборота колеса
+     */
+    onyxup::TimerWheel wheel(10, 100ms, 8);
+    auto now = onyxup::TimerWheel::Clock::now();
+    std::vector<int> expired;
+    wheel.arm(7, now + 2s);
+    for (int i = 1; i < 20; i++) {
+        wheel.expire(now + i * 100ms, expired);
+        ASSERT_EQ(expired.size(), 0);
+    }
+    wheel.expire(now + 2100ms, expired);
+    ASSERT_EQ(expired.size(), 1);
+    ASSERT_EQ(expired[0], 7);
+}
+TEST_F(TimerWheelTests, Test_4) {
+    /*
+     * Пропуск больше одного оборота колеса и просроченный дедлайн
+     */
+    onyxup::TimerWheel wheel(10, 100ms, 8);
+    auto now = onyxup::TimerWheel::Clock::now();
+    std::vector<int> expired;
+    wheel.arm(0, now + 300ms);
+    wheel.arm(4, now + 5s);
+    wheel.arm(9, now + 30s);
+    wheel.expire(now + 10s, expired);
+    std::sort(expired.begin(), expired.end());
+    ASSERT_EQ(expired.size(), 2);
+    ASSERT_EQ(expired[0], 0);
+    ASSERT_EQ(expired[1], 4);
+    wheel.arm(4, now);
+    wheel.expire(now + 10100ms, expired);
+    ASSERT_EQ(expired.size(), 3);
+    ASSERT_EQ(expired[2], 4);
+    ASSERT_TRUE(wheel.isArmed(9));
+}
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}